@@ -0,0 +1,529 @@
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../include/Array.h"
+#include "../include/ConcurrentArray.h"
+#include "../include/Hexagon.h"
+#include "../include/Pentagon.h"
+#include "../include/Rhombus.h"
+
+namespace {
+
+std::atomic<size_t> allocatedBytes{0};
+std::atomic<size_t> allocationCount{0};
+
+}  // namespace
+
+void* operator new(size_t size) {
+    allocatedBytes.fetch_add(size, std::memory_order_relaxed);
+    allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+// GCC принимает free() в замененном operator delete за парный вызов к new.
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+void* operator new[](size_t size) { return operator new(size); }
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+#pragma GCC diagnostic pop
+
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+using Clock = std::chrono::steady_clock;
+
+template <class T>
+void doNotOptimize(const T& value) {
+    asm volatile("" : : "r"(&value) : "memory");
+}
+
+// Замер накапливается только между start() и stop(), подготовка данных не учитывается.
+class Measure {
+public:
+    void start() {
+        bytesAtStart_ = allocatedBytes.load(std::memory_order_relaxed);
+        allocsAtStart_ = allocationCount.load(std::memory_order_relaxed);
+        startedAt_ = Clock::now();
+    }
+
+    void stop() {
+        elapsed_ += Clock::now() - startedAt_;
+        bytes_ += allocatedBytes.load(std::memory_order_relaxed) - bytesAtStart_;
+        allocs_ += allocationCount.load(std::memory_order_relaxed) - allocsAtStart_;
+    }
+
+    double seconds() const { return std::chrono::duration<double>(elapsed_).count(); }
+    size_t bytes() const { return bytes_; }
+    size_t allocs() const { return allocs_; }
+
+private:
+    Clock::time_point startedAt_;
+    Clock::duration elapsed_{};
+    size_t bytesAtStart_ = 0;
+    size_t allocsAtStart_ = 0;
+    size_t bytes_ = 0;
+    size_t allocs_ = 0;
+};
+
+// Одна итерация бенчмарка: возвращает число выполненных операций.
+using Iteration = std::function<size_t(Measure&)>;
+
+struct Case {
+    std::string name;
+    size_t maxSize;
+    std::function<Iteration(size_t)> prepare;
+};
+
+struct Result {
+    std::string name;
+    size_t size = 0;
+    size_t iterations = 0;
+    double nsPerOp = 0.0;
+    double opsPerSec = 0.0;
+    double bytesPerOp = 0.0;
+    double allocsPerOp = 0.0;
+};
+
+struct Options {
+    size_t maxSize = 1000000;
+    double minSeconds = 0.2;
+    std::string filter;
+    std::string output;
+    std::string baseline;
+    double threshold = 0.10;
+};
+
+template <size_t N>
+std::string regularPolygonInput(double radius, double startAngle = 0.0) {
+    std::ostringstream oss;
+    oss << std::setprecision(15);
+    for (size_t i = 0; i < N; ++i) {
+        const double angle = startAngle + 2.0 * PI * static_cast<double>(i) / static_cast<double>(N);
+        oss << radius * std::cos(angle) << ' ' << radius * std::sin(angle) << ' ';
+    }
+    return oss.str();
+}
+
+template <class F>
+struct FigureTraits;
+
+template <>
+struct FigureTraits<Rhombus<double>> {
+    static constexpr const char* kName = "rhombus";
+    static std::string input(size_t i) {
+        const double h = 1.0 + static_cast<double>(i % 7);
+        std::ostringstream oss;
+        oss << "0 0 1 " << h << " 2 0 1 " << -h;
+        return oss.str();
+    }
+};
+
+template <>
+struct FigureTraits<Pentagon<double>> {
+    static constexpr const char* kName = "pentagon";
+    static std::string input(size_t i) {
+        return regularPolygonInput<5>(1.0 + static_cast<double>(i % 7), 0.1 * static_cast<double>(i % 5));
+    }
+};
+
+template <>
+struct FigureTraits<Hexagon<double>> {
+    static constexpr const char* kName = "hexagon";
+    static std::string input(size_t i) {
+        return regularPolygonInput<6>(1.0 + static_cast<double>(i % 7), 0.1 * static_cast<double>(i % 5));
+    }
+};
+
+// Разбор строки дорог, поэтому несколько шаблонов разбираются один раз,
+// а остальные фигуры получаются копированием со сдвигом.
+template <class F>
+std::vector<F> generateFigures(size_t n) {
+    constexpr size_t kTemplates = 35;
+    std::vector<F> templates(std::min(n, kTemplates));
+    for (size_t i = 0; i < templates.size(); ++i) {
+        std::istringstream iss(FigureTraits<F>::input(i));
+        iss >> templates[i];
+    }
+
+    std::vector<F> figures;
+    figures.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        F figure = templates[i % templates.size()];
+        figure.transform(Affine::translation(static_cast<double>(i % 1000) * 20.0,
+                                             static_cast<double>(i / 1000) * 20.0));
+        figures.push_back(std::move(figure));
+    }
+    return figures;
+}
+
+template <class F>
+void addFigureCases(std::vector<Case>& cases) {
+    const std::string name = FigureTraits<F>::kName;
+    constexpr size_t kValueLimit = 1000000;
+
+    cases.push_back({"construct/" + name, kValueLimit, [](size_t n) -> Iteration {
+        return [n](Measure& m) {
+            std::vector<F> figures;
+            figures.reserve(n);
+            m.start();
+            for (size_t i = 0; i < n; ++i) figures.emplace_back();
+            m.stop();
+            return n;
+        };
+    }});
+
+    cases.push_back({"copy/" + name, kValueLimit, [](size_t n) -> Iteration {
+        auto source = std::make_shared<std::vector<F>>(generateFigures<F>(n));
+        return [n, source](Measure& m) {
+            std::vector<F> copies;
+            copies.reserve(n);
+            m.start();
+            for (const auto& f : *source) copies.push_back(f);
+            m.stop();
+            return n;
+        };
+    }});
+
+    cases.push_back({"move/" + name, kValueLimit, [](size_t n) -> Iteration {
+        auto source = std::make_shared<std::vector<F>>(generateFigures<F>(n));
+        return [n, source](Measure& m) {
+            std::vector<F> moved;
+            moved.reserve(n);
+            m.start();
+            for (auto& f : *source) moved.push_back(std::move(f));
+            m.stop();
+            source->swap(moved);
+            return n;
+        };
+    }});
+
+    cases.push_back({"parse/" + name, kValueLimit, [](size_t n) -> Iteration {
+        auto text = std::make_shared<std::string>();
+        for (size_t i = 0; i < n; ++i) *text += FigureTraits<F>::input(i) + "\n";
+        return [n, text](Measure& m) {
+            std::istringstream iss(*text);
+            F figure;
+            m.start();
+            for (size_t i = 0; i < n; ++i) iss >> figure;
+            m.stop();
+            return n;
+        };
+    }});
+
+    cases.push_back({"validate/" + name, kValueLimit, [](size_t n) -> Iteration {
+        auto figures = std::make_shared<std::vector<F>>(generateFigures<F>(n));
+        return [n, figures](Measure& m) {
+            size_t valid = 0;
+            m.start();
+            for (const auto& f : *figures) valid += f.validate();
+            m.stop();
+            doNotOptimize(valid);
+            return n;
+        };
+    }});
+
+    cases.push_back({"equality/" + name, kValueLimit, [](size_t n) -> Iteration {
+        auto figures = std::make_shared<std::vector<F>>(generateFigures<F>(n));
+        return [n, figures](Measure& m) {
+            size_t equal = 0;
+            m.start();
+            for (size_t i = 0; i < n; ++i) equal += (*figures)[i] == (*figures)[(i + 1) % n];
+            m.stop();
+            doNotOptimize(equal);
+            return n;
+        };
+    }});
+}
+
+using SharedFigures = Array<std::shared_ptr<Figure<double>>>;
+
+std::shared_ptr<SharedFigures> generateShared(size_t n) {
+    auto rhombi = generateFigures<Rhombus<double>>(n);
+    auto figures = std::make_shared<SharedFigures>();
+    figures->reserve(n);
+    for (auto& r : rhombi) figures->add(std::make_shared<Rhombus<double>>(std::move(r)));
+    return figures;
+}
+
+void addArrayCases(std::vector<Case>& cases) {
+    cases.push_back({"array/add", SIZE_MAX, [](size_t n) -> Iteration {
+        auto source = generateShared(n);
+        return [n, source](Measure& m) {
+            m.start();
+            SharedFigures figures;
+            for (size_t i = 0; i < n; ++i) figures.add((*source)[i]);
+            m.stop();
+            return n;
+        };
+    }});
+
+    cases.push_back({"array/add_value", 1000000, [](size_t n) -> Iteration {
+        auto source = std::make_shared<std::vector<Pentagon<double>>>(generateFigures<Pentagon<double>>(n));
+        return [n, source](Measure& m) {
+            m.start();
+            Array<Pentagon<double>> pentagons;
+            for (const auto& p : *source) pentagons.add(p);
+            m.stop();
+            return n;
+        };
+    }});
+
+    cases.push_back({"array/remove", 1000000, [](size_t n) -> Iteration {
+        auto source = generateShared(n);
+        return [n, source](Measure& m) {
+            SharedFigures figures;
+            figures.reserve(n);
+            for (size_t i = 0; i < n; ++i) figures.add((*source)[i]);
+            const size_t removals = std::min<size_t>(n, 100);
+            m.start();
+            for (size_t i = 0; i < removals; ++i) figures.remove((n - i) / 2);
+            m.stop();
+            return removals;
+        };
+    }});
+
+    cases.push_back({"array/total_surface", SIZE_MAX, [](size_t n) -> Iteration {
+        auto figures = generateShared(n);
+        return [n, figures](Measure& m) {
+            m.start();
+            const double total = figures->totalSurface();
+            m.stop();
+            doNotOptimize(total);
+            return n;
+        };
+    }});
+
+    cases.push_back({"array/total_surface_value", 1000000, [](size_t n) -> Iteration {
+        auto source = generateFigures<Pentagon<double>>(n);
+        auto pentagons = std::make_shared<Array<Pentagon<double>>>();
+        for (auto& p : source) pentagons->add(std::move(p));
+        return [n, pentagons](Measure& m) {
+            m.start();
+            const double total = pentagons->totalSurface();
+            m.stop();
+            doNotOptimize(total);
+            return n;
+        };
+    }});
+}
+
+// Каждый производитель добавляет свою полосу фигур; база — Array под общим мьютексом.
+void addConcurrentCases(std::vector<Case>& cases) {
+    for (const size_t producers : {1, 2, 4, 8}) {
+        const std::string suffix = "/p" + std::to_string(producers);
+
+        cases.push_back({"concurrent/append" + suffix, 1000000, [producers](size_t n) -> Iteration {
+            auto source = generateShared(n);
+            return [n, producers, source](Measure& m) {
+                ConcurrentArray<std::shared_ptr<Figure<double>>> figures;
+                m.start();
+                parallel_detail::runTasks(producers, [&](size_t p) {
+                    for (size_t i = n * p / producers; i < n * (p + 1) / producers; ++i)
+                        figures.add((*source)[i]);
+                });
+                m.stop();
+                return n;
+            };
+        }});
+
+        cases.push_back({"concurrent/mutex_array" + suffix, 1000000,
+                         [producers](size_t n) -> Iteration {
+            auto source = generateShared(n);
+            return [n, producers, source](Measure& m) {
+                SharedFigures figures;
+                std::mutex mutex;
+                m.start();
+                parallel_detail::runTasks(producers, [&](size_t p) {
+                    for (size_t i = n * p / producers; i < n * (p + 1) / producers; ++i) {
+                        const std::lock_guard lock(mutex);
+                        figures.add((*source)[i]);
+                    }
+                });
+                m.stop();
+                return n;
+            };
+        }});
+    }
+}
+
+Result run(const Case& c, size_t size, const Options& options) {
+    Iteration iteration = c.prepare(size);
+    Measure measure;
+    Result result{c.name, size};
+    size_t ops = 0;
+    while (result.iterations == 0 || measure.seconds() < options.minSeconds) {
+        ops += iteration(measure);
+        ++result.iterations;
+    }
+    const double seconds = measure.seconds();
+    result.nsPerOp = seconds * 1e9 / static_cast<double>(ops);
+    result.opsPerSec = seconds > 0.0 ? static_cast<double>(ops) / seconds : 0.0;
+    result.bytesPerOp = static_cast<double>(measure.bytes()) / static_cast<double>(ops);
+    result.allocsPerOp = static_cast<double>(measure.allocs()) / static_cast<double>(ops);
+    return result;
+}
+
+// Каждый результат — отдельная строка, чтобы сравнение с базой читало файл построчно.
+void writeJson(std::ostream& os, const std::vector<Result>& results) {
+    os << "{\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        os << "    {\"name\": \"" << r.name << "\", \"size\": " << r.size
+           << ", \"iterations\": " << r.iterations << std::fixed << std::setprecision(3)
+           << ", \"ns_per_op\": " << r.nsPerOp << ", \"ops_per_sec\": " << r.opsPerSec
+           << ", \"bytes_per_op\": " << r.bytesPerOp << ", \"allocs_per_op\": " << r.allocsPerOp
+           << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+bool extractField(const std::string& line, const std::string& key, std::string& value) {
+    const std::string marker = "\"" + key + "\": ";
+    const size_t pos = line.find(marker);
+    if (pos == std::string::npos) return false;
+    size_t begin = pos + marker.size();
+    size_t end;
+    if (line[begin] == '"') {
+        ++begin;
+        end = line.find('"', begin);
+    } else {
+        end = line.find_first_of(",}", begin);
+    }
+    if (end == std::string::npos) return false;
+    value = line.substr(begin, end - begin);
+    return true;
+}
+
+std::vector<Result> readJson(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) throw std::runtime_error("Не удалось открыть базовый файл " + path);
+
+    std::vector<Result> results;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::string name, size, ns;
+        if (!extractField(line, "name", name) || !extractField(line, "size", size) ||
+            !extractField(line, "ns_per_op", ns))
+            continue;
+        Result r;
+        r.name = name;
+        r.size = std::stoull(size);
+        r.nsPerOp = std::stod(ns);
+        results.push_back(r);
+    }
+    return results;
+}
+
+size_t compare(const std::vector<Result>& baseline, const std::vector<Result>& current,
+               double threshold) {
+    size_t regressions = 0;
+    for (const auto& now : current) {
+        for (const auto& before : baseline) {
+            if (before.name != now.name || before.size != now.size || before.nsPerOp <= 0.0) continue;
+            const double change = now.nsPerOp / before.nsPerOp - 1.0;
+            if (change > threshold) {
+                ++regressions;
+                std::cerr << std::fixed << std::setprecision(2) << "REGRESSION " << now.name
+                          << " size=" << now.size << ": " << before.nsPerOp << " -> "
+                          << now.nsPerOp << " ns/op (+" << std::setprecision(1)
+                          << change * 100.0 << "%)\n";
+            }
+        }
+    }
+    return regressions;
+}
+
+Options parseOptions(int argc, char** argv) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::invalid_argument("Нет значения для " + arg);
+            return argv[++i];
+        };
+        if (arg == "--max-size")
+            options.maxSize = std::stoull(next());
+        else if (arg == "--min-time")
+            options.minSeconds = std::stod(next());
+        else if (arg == "--filter")
+            options.filter = next();
+        else if (arg == "--output")
+            options.output = next();
+        else if (arg == "--baseline")
+            options.baseline = next();
+        else if (arg == "--threshold")
+            options.threshold = std::stod(next());
+        else
+            throw std::invalid_argument(
+                "Использование: bench [--max-size N] [--min-time сек] [--filter подстрока] "
+                "[--output файл] [--baseline файл] [--threshold доля]");
+    }
+    return options;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    try {
+        const Options options = parseOptions(argc, argv);
+
+        std::vector<Case> cases;
+        addFigureCases<Rhombus<double>>(cases);
+        addFigureCases<Pentagon<double>>(cases);
+        addFigureCases<Hexagon<double>>(cases);
+        addArrayCases(cases);
+        addConcurrentCases(cases);
+
+        std::vector<Result> results;
+        for (const auto& c : cases) {
+            if (c.name.find(options.filter) == std::string::npos) continue;
+            for (size_t size = 10; size <= std::min(options.maxSize, c.maxSize); size *= 10) {
+                results.push_back(run(c, size, options));
+                const auto& r = results.back();
+                std::cerr << std::left << std::setw(28) << r.name << std::right << std::setw(10)
+                          << r.size << std::fixed << std::setprecision(2) << std::setw(14)
+                          << r.nsPerOp << " ns/op" << std::setw(12) << r.bytesPerOp << " B/op\n";
+            }
+        }
+
+        if (options.output.empty()) {
+            writeJson(std::cout, results);
+        } else {
+            std::ofstream out(options.output);
+            writeJson(out, results);
+        }
+
+        if (!options.baseline.empty()) {
+            const size_t regressions =
+                compare(readJson(options.baseline), results, options.threshold);
+            if (regressions > 0) {
+                std::cerr << regressions << " regression(s) over " << std::fixed
+                          << std::setprecision(1) << options.threshold * 100.0 << "%\n";
+                return 1;
+            }
+            std::cerr << "No regressions against " << options.baseline << "\n";
+        }
+    } catch (const std::exception& e) {
+        std::cerr << e.what() << '\n';
+        return 2;
+    }
+    return 0;
+}
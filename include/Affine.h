@@ -0,0 +1,43 @@
+#ifndef AFFINE_H
+#define AFFINE_H
+
+#include <cmath>
+
+#include "Point.h"
+
+// Матрица 2x3: x' = a*x + b*y + tx, y' = c*x + d*y + ty.
+struct Affine {
+    double a = 1.0;
+    double b = 0.0;
+    double tx = 0.0;
+    double c = 0.0;
+    double d = 1.0;
+    double ty = 0.0;
+
+    static Affine translation(double dx, double dy) { return {1.0, 0.0, dx, 0.0, 1.0, dy}; }
+
+    static Affine scaling(double sx, double sy) { return {sx, 0.0, 0.0, 0.0, sy, 0.0}; }
+
+    static Affine rotation(double angle) {
+        const double cs = std::cos(angle);
+        const double sn = std::sin(angle);
+        return {cs, -sn, 0.0, sn, cs, 0.0};
+    }
+
+    // Сначала применяется *this, затем next.
+    Affine then(const Affine& next) const {
+        return {next.a * a + next.b * c, next.a * b + next.b * d, next.a * tx + next.b * ty + next.tx,
+                next.c * a + next.d * c, next.c * b + next.d * d, next.c * tx + next.d * ty + next.ty};
+    }
+
+    double determinant() const { return a * d - b * c; }
+
+    template <IsScalar T>
+    Point<T> apply(const Point<T>& p) const {
+        const double x = static_cast<double>(p.x);
+        const double y = static_cast<double>(p.y);
+        return Point<T>(static_cast<T>(a * x + b * y + tx), static_cast<T>(c * x + d * y + ty));
+    }
+};
+
+#endif
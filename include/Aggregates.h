@@ -0,0 +1,113 @@
+#ifndef AGGREGATES_H
+#define AGGREGATES_H
+
+#include <cmath>
+#include <cstddef>
+#include <typeindex>
+#include <typeinfo>
+#include <unordered_map>
+
+#include "Figure.h"
+
+// Политика агрегатов для Array: onAdd/onRemove вызываются при каждом добавлении,
+// удалении и замене элемента. NoAggregates отключает учет целиком.
+struct NoAggregates {};
+
+namespace aggregate_detail {
+
+// Суммирование Ноймайера: погрешность не растет с числом слагаемых,
+// в том числе при вычитании удаленных элементов.
+class CompensatedSum {
+public:
+    void add(double value) {
+        const double t = sum_ + value;
+        if (std::abs(sum_) >= std::abs(value))
+            compensation_ += (sum_ - t) + value;
+        else
+            compensation_ += (value - t) + sum_;
+        sum_ = t;
+    }
+
+    double value() const { return sum_ + compensation_; }
+
+    void scale(double factor) {
+        sum_ *= factor;
+        compensation_ *= factor;
+    }
+
+private:
+    double sum_ = 0.0;
+    double compensation_ = 0.0;
+};
+
+}  // namespace aggregate_detail
+
+// Суммарная площадь, сумма центров и число фигур каждого типа.
+// Изменение фигуры через указатель мимо Array требует Array::refreshAggregates().
+class FigureAggregates {
+public:
+    template <class E>
+    void onAdd(const E& element) {
+        const auto& fig = figure_detail::figureOf(element);
+        const auto c = fig.center();
+        surface_.add(double(fig));
+        centerX_.add(static_cast<double>(c.x));
+        centerY_.add(static_cast<double>(c.y));
+        ++counts_[typeid(fig)];
+        ++count_;
+    }
+
+    template <class E>
+    void onRemove(const E& element) {
+        const auto& fig = figure_detail::figureOf(element);
+        const auto c = fig.center();
+        surface_.add(-double(fig));
+        centerX_.add(-static_cast<double>(c.x));
+        centerY_.add(-static_cast<double>(c.y));
+        const auto it = counts_.find(typeid(fig));
+        if (it != counts_.end() && --it->second == 0) counts_.erase(it);
+        --count_;
+    }
+
+    // Площадь умножается на |det|, центры переходят по той же матрице.
+    void onTransform(const Affine& m) {
+        const double x = centerX_.value();
+        const double y = centerY_.value();
+        const double n = static_cast<double>(count_);
+        surface_.scale(std::abs(m.determinant()));
+        centerX_ = aggregate_detail::CompensatedSum();
+        centerX_.add(m.a * x);
+        centerX_.add(m.b * y);
+        centerX_.add(m.tx * n);
+        centerY_ = aggregate_detail::CompensatedSum();
+        centerY_.add(m.c * x);
+        centerY_.add(m.d * y);
+        centerY_.add(m.ty * n);
+    }
+
+    double totalSurface() const { return surface_.value(); }
+
+    Point<double> centerSum() const { return Point<double>(centerX_.value(), centerY_.value()); }
+
+    Point<double> meanCenter() const {
+        if (count_ == 0) return Point<double>();
+        return centerSum() / static_cast<double>(count_);
+    }
+
+    template <class F>
+    size_t countOf() const {
+        const auto it = counts_.find(typeid(F));
+        return it == counts_.end() ? 0 : it->second;
+    }
+
+    size_t count() const { return count_; }
+
+private:
+    aggregate_detail::CompensatedSum surface_;
+    aggregate_detail::CompensatedSum centerX_;
+    aggregate_detail::CompensatedSum centerY_;
+    std::unordered_map<std::type_index, size_t> counts_;
+    size_t count_ = 0;
+};
+
+#endif
@@ -1,14 +1,25 @@
 #ifndef ARRAY_H
 #define ARRAY_H
 
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <memory>
+#include <numeric>
+#include <span>
 #include <stdexcept>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "Aggregates.h"
 #include "Figure.h"
+#include "Instrumentation.h"
+#include "Parallel.h"
 
 template <typename>
 struct is_shared_ptr : std::false_type {};
@@ -16,40 +27,241 @@ struct is_shared_ptr : std::false_type {};
 template <typename U>
 struct is_shared_ptr<std::shared_ptr<U>> : std::true_type {};
 
+namespace array_detail {
+
+template <class T, size_t N>
+struct InlineStorage {
+    alignas(T) unsigned char bytes[N * sizeof(T)];
+
+    T* data() { return reinterpret_cast<T*>(bytes); }
+    const T* data() const { return reinterpret_cast<const T*>(bytes); }
+};
+
+template <class T>
+struct InlineStorage<T, 0> {
+    T* data() { return nullptr; }
+    const T* data() const { return nullptr; }
+};
+
+// Кучный буфер со счетчиком владельцев: копии Array и снимки разделяют его,
+// а писатель копирует элементы только при записи в разделяемый буфер.
 template <class T>
+struct SharedBlock {
+    std::atomic<size_t> refs{1};
+    size_t size = 0;
+    size_t capacity = 0;
+    T* data = nullptr;
+
+    static SharedBlock* create(size_t capacity) {
+        auto block = std::make_unique<SharedBlock>();
+        block->data = std::allocator<T>().allocate(capacity);
+        block->capacity = capacity;
+        return block.release();
+    }
+
+    static void release(SharedBlock* block) noexcept {
+        if (block->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        std::destroy_n(block->data, block->size);
+        std::allocator<T>().deallocate(block->data, block->capacity);
+        delete block;
+    }
+};
+
+template <class K>
+struct KeyedIndex {
+    K key;
+    size_t index;
+
+    bool operator<(const KeyedIndex& other) const {
+        return key < other.key || (key == other.key && index < other.index);
+    }
+};
+
+inline uint64_t spreadBits(uint32_t value) {
+    uint64_t x = value;
+    x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+    x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+    x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+    x = (x | (x << 2)) & 0x3333333333333333ull;
+    x = (x | (x << 1)) & 0x5555555555555555ull;
+    return x;
+}
+
+inline uint64_t mortonCode(uint32_t x, uint32_t y) { return spreadBits(x) | (spreadBits(y) << 1); }
+
+inline uint32_t quantize(double value, double min, double extent) {
+    if (extent <= 0.0) return 0;
+    const double scaled = (value - min) / extent * 4294967295.0;
+    return static_cast<uint32_t>(std::clamp(scaled, 0.0, 4294967295.0));
+}
+
+// Метка живых снимков массива указателей; у массивов фигур по значению ее нет.
+struct NoSnapshotGuard {};
+
+}  // namespace array_detail
+
+template <class T, size_t InlineN = 0, class Aggregates = NoAggregates>
 class Array {
 public:
-    Array() : size_(0), capacity_(4), data_(std::make_shared<T[]>(capacity_)) {}
+    class Snapshot;
+
+    static constexpr bool kTracksAggregates = !std::is_same_v<Aggregates, NoAggregates>;
+    static constexpr bool kHoldsValues = requires(T& value) { value.center(); };
+
+    Array() : size_(0), capacity_(InlineN), block_(nullptr) { data_ = inline_.data(); }
+
+    Array(const Array& other) : Array() {
+        if (other.block_) {
+            other.block_->refs.fetch_add(1, std::memory_order_relaxed);
+            block_ = other.block_;
+            data_ = block_->data;
+            capacity_ = other.capacity_;
+            size_ = other.size_;
+            aggregates_ = other.aggregates_;
+            // Через выданные other ссылки буфер еще могут менять, поэтому копия получает свой.
+            if (other.mutableAccess_) detach();
+            return;
+        }
+        for (; size_ < other.size_; ++size_) std::construct_at(data_ + size_, other.data_[size_]);
+        aggregates_ = other.aggregates_;
+    }
+
+    Array(Array&& other) noexcept : Array() { takeFrom(other); }
+
+    Array& operator=(Array other) noexcept {
+        release();
+        takeFrom(other);
+        return *this;
+    }
+
+    ~Array() { release(); }
 
     template <typename U>
     requires(!std::is_pointer_v<T> && !is_shared_ptr<T>::value)
     void add(const U& value) {
-        ensureCapacity();
-        data_[size_++] = value;
+        prepareAppend();
+        std::construct_at(data_ + size_, value);
+        setSize(size_ + 1);
+        onAdded(data_[size_ - 1]);
     }
 
     template <typename U>
     requires(!std::is_pointer_v<T> && !is_shared_ptr<T>::value)
     void add(U&& value) {
-        ensureCapacity();
-        data_[size_++] = std::forward<U>(value);
+        prepareAppend();
+        std::construct_at(data_ + size_, std::forward<U>(value));
+        setSize(size_ + 1);
+        onAdded(data_[size_ - 1]);
     }
 
     template <typename U>
     requires is_shared_ptr<T>::value
     void add(U value) {
-        ensureCapacity();
-        data_[size_++] = std::move(value);
+        prepareAppend();
+        std::construct_at(data_ + size_, std::move(value));
+        setSize(size_ + 1);
+        onAdded(data_[size_ - 1]);
     }
 
     void remove(size_t index) {
         if (index >= size_) throw std::out_of_range("Индекс вне диапазона");
+        detach();
+        onRemoved(data_[index]);
         for (size_t i = index; i + 1 < size_; ++i) data_[i] = std::move(data_[i + 1]);
-        --size_;
+        INSTRUMENT_ADD(ArrayElementMoves, size_ - index - 1);
+        truncate(size_ - 1);
+    }
+
+    void erase(size_t first, size_t last) {
+        if (first > last || last > size_) throw std::out_of_range("Индекс вне диапазона");
+        if (first == last) return;
+        detach();
+        for (size_t i = first; i < last; ++i) onRemoved(data_[i]);
+        std::move(data_ + last, data_ + size_, data_ + first);
+        INSTRUMENT_ADD(ArrayElementMoves, size_ - last);
+        truncate(size_ - (last - first));
     }
 
-    T& operator[](size_t index) {
+    // Порядок не сохраняется: на место удаленного встает последний элемент.
+    void swapRemove(size_t index) {
         if (index >= size_) throw std::out_of_range("Индекс вне диапазона");
+        detach();
+        onRemoved(data_[index]);
+        if (index + 1 != size_) {
+            data_[index] = std::move(data_[size_ - 1]);
+            INSTRUMENT_COUNT(ArrayElementMoves);
+        }
+        truncate(size_ - 1);
+    }
+
+    template <typename Pred>
+    size_t removeIf(Pred pred) {
+        auto drop = [&](const T& value) {
+            if (!std::invoke(pred, value)) return false;
+            onRemoved(value);
+            return true;
+        };
+
+        const size_t oldSize = size_;
+        if (isShared()) {
+            // Буфер остается прежним, поэтому отменяется только учет отброшенных.
+            try {
+                reallocate(capacity_, drop);
+            } catch (...) {
+                refreshAggregates();
+                throw;
+            }
+            return oldSize - size_;
+        }
+
+        // Если pred бросает, уже отброшенные удаляются, а непроверенные сохраняются.
+        size_t kept = 0;
+        size_t i = 0;
+        auto keep = [&] {
+            if (kept != i) {
+                data_[kept] = std::move(data_[i]);
+                INSTRUMENT_COUNT(ArrayElementMoves);
+            }
+            ++kept;
+        };
+        try {
+            for (; i < size_; ++i) {
+                if (!drop(std::as_const(data_[i]))) keep();
+            }
+        } catch (...) {
+            for (; i < size_; ++i) keep();
+            truncate(kept);
+            throw;
+        }
+        truncate(kept);
+        return oldSize - kept;
+    }
+
+    template <typename U>
+    void replace(size_t index, U&& value) {
+        update(index, [&](T& current) { current = std::forward<U>(value); });
+    }
+
+    template <typename Fn>
+    void update(size_t index, Fn fn) {
+        if (index >= size_) throw std::out_of_range("Индекс вне диапазона");
+        detach();
+        onRemoved(data_[index]);
+        // Элемент остается в массиве и при исключении, поэтому снова учитывается.
+        try {
+            std::invoke(fn, data_[index]);
+        } catch (...) {
+            onAdded(data_[index]);
+            throw;
+        }
+        onAdded(data_[index]);
+    }
+
+    // При включенных агрегатах изменять элементы можно только через replace/update.
+    T& operator[](size_t index) requires(!kTracksAggregates) {
+        if (index >= size_) throw std::out_of_range("Индекс вне диапазона");
+        detach();
+        mutableAccess_ = true;
         return data_[index];
     }
 
@@ -58,6 +270,118 @@ public:
         return data_[index];
     }
 
+    // Без проверки границ; для записи в горячих циклах берите span() один раз.
+    const T& unchecked(size_t index) const { return data_[index]; }
+
+    T* data() requires(!kTracksAggregates) {
+        detach();
+        mutableAccess_ = true;
+        return data_;
+    }
+
+    const T* data() const { return data_; }
+
+    T* begin() requires(!kTracksAggregates) { return data(); }
+    T* end() requires(!kTracksAggregates) { return data() + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+
+    std::span<T> span() requires(!kTracksAggregates) { return {data(), size_}; }
+    std::span<const T> span() const { return {data_, size_}; }
+
+    // Ключи (площадь, код Мортона центра) считаются один раз на элемент,
+    // затем сортируется компактный массив пар ключ/индекс.
+    std::vector<size_t> orderBySurface(Execution execution = Execution::Sequential) const {
+        INSTRUMENT_SCOPE("array.order");
+        auto keys = surfaceKeys(execution);
+        parallel_detail::parallelSort(execution, keys.begin(), keys.end(), std::less<>());
+        return indicesOf(keys);
+    }
+
+    std::vector<size_t> orderByMorton(Execution execution = Execution::Sequential) const {
+        INSTRUMENT_SCOPE("array.order");
+        auto keys = mortonKeys(execution);
+        parallel_detail::parallelSort(execution, keys.begin(), keys.end(), std::less<>());
+        return indicesOf(keys);
+    }
+
+    // Индексы k фигур с наибольшей площадью, по убыванию площади.
+    std::vector<size_t> topBySurface(size_t k, Execution execution = Execution::Sequential) const {
+        INSTRUMENT_SCOPE("array.top");
+        auto keys = surfaceKeys(execution);
+        k = std::min(k, keys.size());
+        const auto larger = [](const auto& lhs, const auto& rhs) {
+            return lhs.key > rhs.key || (lhs.key == rhs.key && lhs.index < rhs.index);
+        };
+        std::nth_element(keys.begin(), keys.begin() + k, keys.end(), larger);
+        keys.resize(k);
+        std::sort(keys.begin(), keys.end(), larger);
+        return indicesOf(keys);
+    }
+
+    void sortBySurface(Execution execution = Execution::Sequential) {
+        permute(orderBySurface(execution));
+    }
+
+    void sortByMorton(Execution execution = Execution::Sequential) {
+        permute(orderByMorton(execution));
+    }
+
+    // Фигура, записанная в несколько ячеек, преобразуется один раз, как и вершина пула,
+    // общая для нескольких видов мозаики. Фигуры по указателю общие со снимками даже
+    // после add/remove, поэтому, пока жив хотя бы один снимок, такое преобразование запрещено.
+    void transform(const Affine& m, Execution execution = Execution::Sequential) {
+        INSTRUMENT_SCOPE("array.transform");
+        if constexpr (kHoldsValues) {
+            detach();
+            const bool pooled = [&] {
+                if constexpr (requires(const T& value) { value.vertexPool(); })
+                    return std::any_of(data_, data_ + size_,
+                                       [](const T& value) { return value.vertexPool(); });
+                else
+                    return false;
+            }();
+            if (pooled) {
+                std::vector<T*> figures(size_);
+                for (size_t i = 0; i < size_; ++i) figures[i] = data_ + i;
+                transformFigures(figures, m, execution);
+            } else {
+                parallel_detail::parallelFor(execution, size_, [&](size_t first, size_t last) {
+                    for (size_t i = first; i < last; ++i) data_[i].transform(m);
+                });
+            }
+        } else {
+            if (snapshotGuard_.use_count() > 1)
+                throw std::logic_error("Фигуры используются снимком массива");
+            std::vector<std::remove_reference_t<decltype(*data_[0])>*> figures(size_);
+            for (size_t i = 0; i < size_; ++i) figures[i] = &*data_[i];
+            std::sort(figures.begin(), figures.end(), std::less<>());
+            figures.erase(std::unique(figures.begin(), figures.end()), figures.end());
+            const size_t distinct = figures.size();
+            transformFigures(figures, m, execution);
+            if (distinct != size_) {
+                refreshAggregates();
+                return;
+            }
+        }
+        if constexpr (requires { aggregates_.onTransform(m); })
+            aggregates_.onTransform(m);
+        else
+            refreshAggregates();
+    }
+
+    // Снимок делит буфер с массивом за O(1); его можно передать читающим потокам,
+    // пока владелец продолжает add/remove. Сам вызов snapshot() — на стороне писателя.
+    // Если после последнего перевыделения писатель брал изменяемые ссылки, указатели
+    // или span (operator[], data(), begin(), span()), снимок копирует буфер, и запись
+    // через них снимку не видна.
+    Snapshot snapshot() const {
+        if constexpr (!kHoldsValues) {
+            if (!snapshotGuard_) snapshotGuard_ = std::make_shared<const bool>(true);
+        }
+        return Snapshot(*this);
+    }
+
     void printSurfaces() const {
         std::cout << std::fixed << std::setprecision(2);
         for (size_t i = 0; i < size_; ++i) {
@@ -84,37 +408,287 @@ public:
     }
 
     double totalSurface() const {
-        double sum = 0.0;
-        for (size_t i = 0; i < size_; ++i) {
-            if constexpr (requires { double(data_[i]); }) {
-                sum += double(data_[i]);
-            } else if constexpr (requires { double(*data_[i]); }) {
-                sum += double(*data_[i]);
-            }
-        }
-        return sum;
+        if constexpr (requires { aggregates_.totalSurface(); }) return aggregates_.totalSurface();
+
+        return std::transform_reduce(begin(), end(), 0.0, std::plus<>(), [](const T& value) {
+            if constexpr (requires { double(value); })
+                return double(value);
+            else if constexpr (requires { double(*value); })
+                return double(*value);
+            else
+                return 0.0;
+        });
     }
 
     void print() const {
         for (size_t i = 0; i < size_; ++i) std::cout << "[" << i << "] " << data_[i] << "\n";
     }
 
+    void reserve(size_t capacity) {
+        if (capacity > capacity_) reallocate(capacity);
+    }
+
+    const Aggregates& aggregates() const { return aggregates_; }
+
+    void refreshAggregates() {
+        if constexpr (kTracksAggregates) {
+            aggregates_ = Aggregates();
+            for (size_t i = 0; i < size_; ++i) aggregates_.onAdd(data_[i]);
+        }
+    }
+
     size_t getSize() const { return size_; }
     size_t getCapacity() const { return capacity_; }
+    bool isInline() const { return block_ == nullptr; }
+    bool isShared() const {
+        return block_ && block_->refs.load(std::memory_order_acquire) != 1;
+    }
 
 private:
+    using Block = array_detail::SharedBlock<T>;
+
+    static constexpr size_t kInitialCapacity = 4;
+
+    [[no_unique_address]] array_detail::InlineStorage<T, InlineN> inline_;
     size_t size_;
     size_t capacity_;
-    std::shared_ptr<T[]> data_;
+    T* data_;
+    Block* block_;
+    [[no_unique_address]] Aggregates aggregates_;
+    bool mutableAccess_ = false;
+    using SnapshotGuard =
+        std::conditional_t<kHoldsValues, array_detail::NoSnapshotGuard, std::shared_ptr<const bool>>;
+    [[no_unique_address]] mutable SnapshotGuard snapshotGuard_;
+
+    void onAdded(const T& value) {
+        if constexpr (kTracksAggregates) aggregates_.onAdd(value);
+    }
+
+    void onRemoved(const T& value) {
+        if constexpr (kTracksAggregates) aggregates_.onRemove(value);
+    }
+
+    // Виды на общий пул вершин убираются из figures; каждая вершина пула,
+    // на которую ссылается хотя бы один вид, преобразуется ровно один раз.
+    template <class F>
+    static void transformFigures(std::vector<F*>& figures, const Affine& m, Execution execution) {
+        if constexpr (requires { figures[0]->vertexPool(); }) transformPooled(figures, m);
+        parallel_detail::parallelFor(execution, figures.size(), [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) figures[i]->transform(m);
+        });
+    }
+
+    template <class F>
+    static void transformPooled(std::vector<F*>& figures, const Affine& m) {
+        using Pool = std::remove_pointer_t<decltype(figures[0]->vertexPool())>;
+        std::vector<std::pair<Pool*, uint32_t>> vertices;
+        std::erase_if(figures, [&](F* figure) {
+            Pool* pool = figure->vertexPool();
+            if (!pool) return false;
+            for (const uint32_t index : figure->poolIndices()) vertices.emplace_back(pool, index);
+            return true;
+        });
+        std::sort(vertices.begin(), vertices.end(), [](const auto& lhs, const auto& rhs) {
+            return std::less<>()(lhs.first, rhs.first) ||
+                   (lhs.first == rhs.first && lhs.second < rhs.second);
+        });
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+
+        std::vector<uint32_t> indices;
+        for (size_t first = 0; first < vertices.size();) {
+            size_t last = first;
+            indices.clear();
+            for (; last < vertices.size() && vertices[last].first == vertices[first].first; ++last)
+                indices.push_back(vertices[last].second);
+            vertices[first].first->transformVertices(indices, m);
+            first = last;
+        }
+    }
+
+    template <class K, class KeyFn>
+    std::vector<array_detail::KeyedIndex<K>> computeKeys(Execution execution, KeyFn keyOf) const {
+        std::vector<array_detail::KeyedIndex<K>> keys(size_);
+        parallel_detail::parallelFor(execution, size_, [&](size_t first, size_t last) {
+            for (size_t i = first; i < last; ++i) keys[i] = {keyOf(data_[i]), i};
+        });
+        return keys;
+    }
+
+    std::vector<array_detail::KeyedIndex<double>> surfaceKeys(Execution execution) const {
+        return computeKeys<double>(execution, [](const T& value) {
+            return double(figure_detail::figureOf(value));
+        });
+    }
+
+    std::vector<array_detail::KeyedIndex<uint64_t>> mortonKeys(Execution execution) const {
+        auto centers = computeKeys<Point<double>>(execution, [](const T& value) {
+            const auto c = figure_detail::figureOf(value).center();
+            return Point<double>(static_cast<double>(c.x), static_cast<double>(c.y));
+        });
+        if (centers.empty()) return {};
+
+        Point<double> lo = centers[0].key;
+        Point<double> hi = centers[0].key;
+        for (const auto& c : centers) {
+            lo = Point<double>(std::min(lo.x, c.key.x), std::min(lo.y, c.key.y));
+            hi = Point<double>(std::max(hi.x, c.key.x), std::max(hi.y, c.key.y));
+        }
 
-    void ensureCapacity() {
-        if (size_ < capacity_) return;
+        std::vector<array_detail::KeyedIndex<uint64_t>> keys(centers.size());
+        for (size_t i = 0; i < centers.size(); ++i) {
+            const auto& c = centers[i].key;
+            keys[i] = {array_detail::mortonCode(array_detail::quantize(c.x, lo.x, hi.x - lo.x),
+                                                array_detail::quantize(c.y, lo.y, hi.y - lo.y)),
+                       i};
+        }
+        return keys;
+    }
+
+    template <class K>
+    static std::vector<size_t> indicesOf(const std::vector<array_detail::KeyedIndex<K>>& keys) {
+        std::vector<size_t> indices(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i) indices[i] = keys[i].index;
+        return indices;
+    }
+
+    // После перестановки на позиции i оказывается бывший элемент order[i].
+    void permute(const std::vector<size_t>& order) {
+        detach();
+        std::vector<bool> placed(size_, false);
+        for (size_t start = 0; start < size_; ++start) {
+            if (placed[start]) continue;
+            T moved = std::move(data_[start]);
+            size_t i = start;
+            while (order[i] != start) {
+                data_[i] = std::move(data_[order[i]]);
+                INSTRUMENT_COUNT(ArrayElementMoves);
+                placed[i] = true;
+                i = order[i];
+            }
+            data_[i] = std::move(moved);
+            INSTRUMENT_ADD(ArrayElementMoves, 2);
+            placed[i] = true;
+        }
+    }
+
+    void setSize(size_t size) {
+        size_ = size;
+        if (block_) block_->size = size;
+    }
+
+    void prepareAppend() {
+        if (size_ < capacity_) {
+            detach();
+            return;
+        }
+        reallocate(capacity_ == 0 ? kInitialCapacity : capacity_ * 2);
+    }
+
+    void detach() {
+        if (isShared()) reallocate(capacity_);
+    }
+
+    void truncate(size_t size) {
+        std::destroy(data_ + size, data_ + size_);
+        setSize(size);
+    }
+
+    // Из разделяемого буфера элементы копируются, из собственного — перемещаются.
+    // Элементы, для которых skip возвращает true, в новый буфер не попадают.
+    template <typename Skip = bool (*)(const T&)>
+    void reallocate(size_t capacity, Skip skip = [](const T&) { return false; }) {
+        Block* fresh = Block::create(capacity);
+        const bool shared = isShared();
+        try {
+            for (size_t i = 0; i < size_; ++i) {
+                if (std::invoke(skip, std::as_const(data_[i]))) continue;
+                if (shared)
+                    std::construct_at(fresh->data + fresh->size, std::as_const(data_[i]));
+                else
+                    std::construct_at(fresh->data + fresh->size, std::move(data_[i]));
+                ++fresh->size;
+            }
+        } catch (...) {
+            Block::release(fresh);
+            throw;
+        }
+
+        if (!shared) {
+            std::destroy_n(data_, size_);
+            setSize(0);
+        }
+        if (block_) Block::release(block_);
+
+        INSTRUMENT_COUNT(ArrayReallocations);
+        if (shared)
+            INSTRUMENT_ADD(ArrayElementCopies, fresh->size);
+        else
+            INSTRUMENT_ADD(ArrayElementMoves, fresh->size);
+
+        block_ = fresh;
+        data_ = fresh->data;
+        mutableAccess_ = false;
+        size_ = fresh->size;
+        capacity_ = capacity;
+    }
+
+    void release() noexcept {
+        if (block_)
+            Block::release(block_);
+        else
+            std::destroy_n(data_, size_);
+        size_ = 0;
+        capacity_ = InlineN;
+        data_ = inline_.data();
+        block_ = nullptr;
+        aggregates_ = Aggregates();
+        snapshotGuard_ = SnapshotGuard();
+        mutableAccess_ = false;
+    }
 
-        capacity_ *= 2;
-        auto newData = std::make_shared<T[]>(capacity_);
-        for (size_t i = 0; i < size_; ++i) newData[i] = std::move(data_[i]);
-        data_ = std::move(newData);
+    void takeFrom(Array& other) noexcept {
+        aggregates_ = std::exchange(other.aggregates_, Aggregates());
+        snapshotGuard_ = std::exchange(other.snapshotGuard_, SnapshotGuard());
+        mutableAccess_ = std::exchange(other.mutableAccess_, false);
+        if (other.isInline()) {
+            for (; size_ < other.size_; ++size_) {
+                std::construct_at(data_ + size_, std::move(other.data_[size_]));
+                std::destroy_at(other.data_ + size_);
+            }
+            INSTRUMENT_ADD(ArrayElementMoves, size_);
+            other.size_ = 0;
+            return;
+        }
+        block_ = std::exchange(other.block_, nullptr);
+        data_ = std::exchange(other.data_, other.inline_.data());
+        capacity_ = std::exchange(other.capacity_, InlineN);
+        size_ = std::exchange(other.size_, 0);
     }
 };
 
+template <class T, size_t InlineN, class Aggregates>
+class Array<T, InlineN, Aggregates>::Snapshot {
+public:
+    const T& operator[](size_t index) const { return array_[index]; }
+    const T& unchecked(size_t index) const { return array_.unchecked(index); }
+    const T* data() const { return array_.data(); }
+    const T* begin() const { return array_.begin(); }
+    const T* end() const { return array_.end(); }
+    std::span<const T> span() const { return array_.span(); }
+    size_t getSize() const { return array_.getSize(); }
+    double totalSurface() const { return array_.totalSurface(); }
+    const Aggregates& aggregates() const { return array_.aggregates(); }
+    void printSurfaces() const { array_.printSurfaces(); }
+    void printCenters() const { array_.printCenters(); }
+    void print() const { array_.print(); }
+
+private:
+    friend class Array;
+
+    explicit Snapshot(const Array& array) : array_(array), guard_(array.snapshotGuard_) {}
+
+    Array array_;
+    [[no_unique_address]] SnapshotGuard guard_;
+};
+
 #endif
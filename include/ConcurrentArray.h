@@ -0,0 +1,116 @@
+#ifndef CONCURRENT_ARRAY_H
+#define CONCURRENT_ARRAY_H
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "Array.h"
+
+// Сегмент k хранит kFirstSegment * 2^k элементов; уже выделенные сегменты
+// никогда не перемещаются, поэтому ссылки на опубликованные элементы стабильны.
+template <class T>
+class ConcurrentArray {
+public:
+    ConcurrentArray() = default;
+
+    ConcurrentArray(const ConcurrentArray&) = delete;
+    ConcurrentArray& operator=(const ConcurrentArray&) = delete;
+
+    ~ConcurrentArray() { clear(); }
+
+    template <typename U>
+    size_t add(U&& value) {
+        const size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slotAt(index);
+        std::construct_at(slot.ptr(), std::forward<U>(value));
+        slot.ready.store(true, std::memory_order_release);
+        return index;
+    }
+
+    const T* find(size_t index) const noexcept {
+        if (index >= reserved_.load(std::memory_order_acquire)) return nullptr;
+        const auto [segment, offset] = locate(index);
+        const Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (!slots || !slots[offset].ready.load(std::memory_order_acquire)) return nullptr;
+        return slots[offset].ptr();
+    }
+
+    const T& operator[](size_t index) const {
+        if (index >= getSize()) throw std::out_of_range("Индекс вне диапазона");
+        const T* value = find(index);
+        if (!value) throw std::out_of_range("Элемент еще не опубликован");
+        return *value;
+    }
+
+    size_t getSize() const { return reserved_.load(std::memory_order_acquire); }
+
+    // Вызывается, когда писатели остановлены: элементы переносятся в непрерывный Array.
+    Array<T> freeze() {
+        Array<T> result;
+        const size_t size = getSize();
+        result.reserve(size);
+        for (size_t i = 0; i < size; ++i) {
+            const auto [segment, offset] = locate(i);
+            Slot* slots = segments_[segment].load(std::memory_order_acquire);
+            if (slots && slots[offset].ready.load(std::memory_order_acquire))
+                result.add(std::move(*slots[offset].ptr()));
+        }
+        clear();
+        return result;
+    }
+
+private:
+    static constexpr size_t kFirstSegment = 8;
+    static constexpr size_t kMaxSegments = 48;
+
+    struct Slot {
+        std::atomic<bool> ready{false};
+        alignas(T) unsigned char bytes[sizeof(T)];
+
+        T* ptr() { return reinterpret_cast<T*>(bytes); }
+        const T* ptr() const { return reinterpret_cast<const T*>(bytes); }
+    };
+
+    std::atomic<size_t> reserved_{0};
+    std::atomic<Slot*> segments_[kMaxSegments] = {};
+
+    static size_t segmentSize(size_t segment) { return kFirstSegment << segment; }
+
+    static std::pair<size_t, size_t> locate(size_t index) {
+        const size_t block = index / kFirstSegment + 1;
+        const size_t segment = std::bit_width(block) - 1;
+        return {segment, index - kFirstSegment * ((size_t{1} << segment) - 1)};
+    }
+
+    Slot& slotAt(size_t index) {
+        const auto [segment, offset] = locate(index);
+        if (segment >= kMaxSegments) throw std::length_error("Превышена емкость массива");
+
+        Slot* slots = segments_[segment].load(std::memory_order_acquire);
+        if (!slots) {
+            auto fresh = std::make_unique<Slot[]>(segmentSize(segment));
+            if (segments_[segment].compare_exchange_strong(slots, fresh.get(),
+                                                           std::memory_order_acq_rel))
+                slots = fresh.release();
+        }
+        return slots[offset];
+    }
+
+    void clear() {
+        for (size_t s = 0; s < kMaxSegments; ++s) {
+            Slot* slots = segments_[s].exchange(nullptr, std::memory_order_acq_rel);
+            if (!slots) continue;
+            for (size_t i = 0; i < segmentSize(s); ++i) {
+                if (slots[i].ready.load(std::memory_order_relaxed)) std::destroy_at(slots[i].ptr());
+            }
+            delete[] slots;
+        }
+        reserved_.store(0, std::memory_order_release);
+    }
+};
+
+#endif
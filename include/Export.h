@@ -0,0 +1,302 @@
+#ifndef EXPORT_H
+#define EXPORT_H
+
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include "Figure.h"
+
+enum class ExportFormat { Text, Csv, Json };
+
+namespace export_detail {
+
+constexpr int kMaxFastPrecision = 9;
+constexpr double kPowers[kMaxFastPrecision + 1] = {1e0, 1e1, 1e2, 1e3, 1e4,
+                                                   1e5, 1e6, 1e7, 1e8, 1e9};
+
+// Быстрый путь для %.Nf: округление value * 10^N до целого с точной поправкой
+// через fma, половины — к четному, как у printf. nullptr, если значение
+// вне диапазона, где такое округление точно.
+inline char* formatFixed(char* out, double value, int precision) {
+    if (precision < 0 || precision > kMaxFastPrecision || !std::isfinite(value)) return nullptr;
+    const double scale = kPowers[precision];
+    const double magnitude = std::abs(value);
+    if (magnitude * scale >= 4503599627370496.0) return nullptr;  // 2^52
+
+    // Ненулевое half не меньше ulp(scaled) и перевешивает ошибку умножения,
+    // поэтому точная поправка нужна только на видимой половине.
+    const double scaled = magnitude * scale;
+    auto rounded = static_cast<uint64_t>(scaled);
+    const double half = (scaled - static_cast<double>(rounded)) - 0.5;
+    if (half > 0.0) {
+        ++rounded;
+    } else if (half == 0.0) {
+        const double error = std::fma(magnitude, scale, -scaled);
+        if (error > 0.0 || (error == 0.0 && rounded % 2 == 1)) ++rounded;
+    }
+
+    if (std::signbit(value)) *out++ = '-';
+    const auto factor = static_cast<uint64_t>(scale);
+    const uint64_t integral = rounded / factor;
+    out = std::to_chars(out, out + 24, integral).ptr;
+    if (precision == 0) return out;
+
+    *out++ = '.';
+    uint64_t fraction = rounded - integral * factor;
+    for (int i = precision - 1; i >= 0; --i) {
+        out[i] = static_cast<char>('0' + fraction % 10);
+        fraction /= 10;
+    }
+    return out + precision;
+}
+
+}  // namespace export_detail
+
+class FileDescriptorSink {
+public:
+    explicit FileDescriptorSink(int fd) : fd_(fd) {}
+
+    void write(const char* data, size_t size) {
+        while (size > 0) {
+            const ssize_t written = ::write(fd_, data, size);
+            if (written < 0) {
+                if (errno == EINTR) continue;
+                throw std::system_error(errno, std::generic_category(), "Ошибка записи");
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
+        }
+    }
+
+private:
+    int fd_;
+};
+
+class StreamSink {
+public:
+    explicit StreamSink(std::ostream& os) : os_(os) {}
+
+    void write(const char* data, size_t size) {
+        os_.write(data, static_cast<std::streamsize>(size));
+    }
+
+private:
+    std::ostream& os_;
+};
+
+class StringSink {
+public:
+    void write(const char* data, size_t size) { out_.append(data, size); }
+
+    const std::string& str() const { return out_; }
+
+private:
+    std::string out_;
+};
+
+// Числа форматируются через std::to_chars (без локали) в общий буфер,
+// который уходит в приемник крупными блоками. Формат Text совпадает
+// с Array::printSurfaces/printCenters при точности 2.
+template <class Sink>
+class Exporter {
+public:
+    explicit Exporter(Sink& sink, ExportFormat format = ExportFormat::Text, int precision = 2,
+                      size_t bufferSize = kDefaultBufferSize)
+        : sink_(sink), format_(format), precision_(precision), buffer_(bufferSize), used_(0) {
+        if (precision < 0 || precision > kMaxPrecision)
+            throw std::invalid_argument("Недопустимая точность вывода");
+    }
+
+    Exporter(const Exporter&) = delete;
+    Exporter& operator=(const Exporter&) = delete;
+
+    ~Exporter() {
+        try {
+            flush();
+        } catch (...) {
+        }
+    }
+
+    template <class Range>
+    void writeSurfaces(const Range& figures) {
+        INSTRUMENT_SCOPE("export.surfaces");
+        if (format_ == ExportFormat::Csv) append("index,area,center_x,center_y,vertices\n");
+        if (format_ == ExportFormat::Json) append("[");
+
+        size_t index = 0;
+        for (const auto& element : figures) {
+            const auto& fig = figure_detail::figureOf(element);
+            switch (format_) {
+                case ExportFormat::Text:
+                    appendNumber(index);
+                    append(": ");
+                    for (size_t v = 0; v < fig.vertexCount(); ++v) {
+                        appendPoint(fig.vertex(v));
+                        append(" ");
+                    }
+                    append(" | Площадь = ");
+                    appendNumber(double(fig));
+                    append("\n");
+                    break;
+                case ExportFormat::Csv:
+                    appendNumber(index);
+                    append(",");
+                    appendNumber(double(fig));
+                    append(",");
+                    appendCoordinates(fig.center(), ",");
+                    append(",");
+                    for (size_t v = 0; v < fig.vertexCount(); ++v) {
+                        if (v > 0) append(" ");
+                        appendCoordinates(fig.vertex(v), " ");
+                    }
+                    append("\n");
+                    break;
+                case ExportFormat::Json:
+                    append(index == 0 ? "\n" : ",\n");
+                    append("{\"index\":");
+                    appendNumber(index);
+                    append(",\"area\":");
+                    appendNumber(double(fig));
+                    append(",\"center\":[");
+                    appendCoordinates(fig.center(), ",");
+                    append("],\"vertices\":[");
+                    for (size_t v = 0; v < fig.vertexCount(); ++v) {
+                        append(v == 0 ? "[" : ",[");
+                        appendCoordinates(fig.vertex(v), ",");
+                        append("]");
+                    }
+                    append("]}");
+                    break;
+            }
+            ++index;
+        }
+
+        if (format_ == ExportFormat::Json) append("\n]\n");
+    }
+
+    template <class Range>
+    void writeCenters(const Range& figures) {
+        INSTRUMENT_SCOPE("export.centers");
+        if (format_ == ExportFormat::Csv) append("index,center_x,center_y\n");
+        if (format_ == ExportFormat::Json) append("[");
+
+        size_t index = 0;
+        for (const auto& element : figures) {
+            const auto c = figure_detail::figureOf(element).center();
+            switch (format_) {
+                case ExportFormat::Text:
+                    appendNumber(index);
+                    append(": Центр = ");
+                    appendPoint(c);
+                    append("\n");
+                    break;
+                case ExportFormat::Csv:
+                    appendNumber(index);
+                    append(",");
+                    appendCoordinates(c, ",");
+                    append("\n");
+                    break;
+                case ExportFormat::Json:
+                    append(index == 0 ? "\n[" : ",\n[");
+                    appendCoordinates(c, ",");
+                    append("]");
+                    break;
+            }
+            ++index;
+        }
+
+        if (format_ == ExportFormat::Json) append("\n]\n");
+    }
+
+    void flush() {
+        if (used_ == 0) return;
+        sink_.write(buffer_.data(), used_);
+        used_ = 0;
+    }
+
+private:
+    static constexpr size_t kDefaultBufferSize = 1 << 20;
+    static constexpr size_t kMaxNumberLength = 512;
+    // Знак, 309 цифр целой части DBL_MAX, точка и дробная часть помещаются в kMaxNumberLength.
+    static constexpr int kMaxPrecision = 100;
+
+    Sink& sink_;
+    ExportFormat format_;
+    int precision_;
+    std::vector<char> buffer_;
+    size_t used_;
+
+    void append(std::string_view text) {
+        if (buffer_.size() - used_ < text.size()) {
+            flush();
+            if (text.size() > buffer_.size()) {
+                sink_.write(text.data(), text.size());
+                return;
+            }
+        }
+        text.copy(buffer_.data() + used_, text.size());
+        used_ += text.size();
+    }
+
+    template <class N>
+    void appendNumber(N value) {
+        if constexpr (std::is_floating_point_v<N>) {
+            if (format_ == ExportFormat::Json && !std::isfinite(value)) {
+                append("null");
+                return;
+            }
+        }
+        if (buffer_.size() - used_ < kMaxNumberLength) flush();
+        const bool direct = buffer_.size() - used_ >= kMaxNumberLength;
+
+        char local[kMaxNumberLength];
+        char* first = direct ? buffer_.data() + used_ : local;
+        char* last = first + kMaxNumberLength;
+        char* end = nullptr;
+        if constexpr (std::is_floating_point_v<N>) {
+            end = export_detail::formatFixed(first, static_cast<double>(value), precision_);
+            if (!end)
+                end = checked(std::to_chars(first, last, value, std::chars_format::fixed, precision_));
+        } else {
+            end = checked(std::to_chars(first, last, value));
+        }
+
+        if (direct)
+            used_ = static_cast<size_t>(end - buffer_.data());
+        else
+            append(std::string_view(local, static_cast<size_t>(end - local)));
+    }
+
+    static char* checked(std::to_chars_result result) {
+        if (result.ec != std::errc()) throw std::length_error("Число не помещается в буфер вывода");
+        return result.ptr;
+    }
+
+    template <IsScalar T>
+    void appendCoordinates(const Point<T>& p, std::string_view separator) {
+        appendNumber(p.x);
+        append(separator);
+        appendNumber(p.y);
+    }
+
+    template <IsScalar T>
+    void appendPoint(const Point<T>& p) {
+        append("(");
+        appendCoordinates(p, ", ");
+        append(")");
+    }
+};
+
+#endif
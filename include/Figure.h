@@ -2,20 +2,31 @@
 #define FIGURE_H
 
 #include <cmath>
+#include <cstdint>
 #include <iostream>
 #include <memory>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <utility>
 
+#include "Affine.h"
+#include "Instrumentation.h"
 #include "Point.h"
 
 namespace figure_detail {
 
 constexpr double kEps = 1e-6;
 
-template <IsScalar T, size_t N>
-Point<T> centroid(const std::unique_ptr<Point<T>> (&vertices)[N]) {
+// V — указатель на вершину: std::unique_ptr<Point<T>> у фигур или const Point<T>* у видов.
+template <class V>
+using VertexPoint = std::remove_cvref_t<decltype(*std::declval<const V&>())>;
+
+template <class V, size_t N>
+VertexPoint<V> centroid(const V (&vertices)[N]) {
+    using T = decltype(VertexPoint<V>::x);
     double sumX = 0.0;
     double sumY = 0.0;
     for (const auto& v : vertices) {
@@ -25,8 +36,8 @@ Point<T> centroid(const std::unique_ptr<Point<T>> (&vertices)[N]) {
     return Point<T>(static_cast<T>(sumX / N), static_cast<T>(sumY / N));
 }
 
-template <IsScalar T, size_t N>
-double surface(const std::unique_ptr<Point<T>> (&vertices)[N]) {
+template <class V, size_t N>
+double surface(const V (&vertices)[N]) {
     double area = 0.0;
     for (size_t i = 0; i < N; ++i) {
         const auto& current = vertices[i];
@@ -38,7 +49,12 @@ double surface(const std::unique_ptr<Point<T>> (&vertices)[N]) {
 }
 
 template <IsScalar T, size_t N>
-bool hasDuplicateVertices(const std::unique_ptr<Point<T>> (&vertices)[N]) {
+void transform(std::unique_ptr<Point<T>> (&vertices)[N], const Affine& m) {
+    for (auto& v : vertices) *v = m.apply(*v);
+}
+
+template <class V, size_t N>
+bool hasDuplicateVertices(const V (&vertices)[N]) {
     for (size_t i = 0; i < N; ++i) {
         for (size_t j = i + 1; j < N; ++j) {
             if (*vertices[i] == *vertices[j]) return true;
@@ -47,9 +63,8 @@ bool hasDuplicateVertices(const std::unique_ptr<Point<T>> (&vertices)[N]) {
     return false;
 }
 
-template <IsScalar T, size_t N>
-bool sequencesEqual(const std::unique_ptr<Point<T>> (&lhs)[N],
-                    const std::unique_ptr<Point<T>> (&rhs)[N]) {
+template <class L, class R, size_t N>
+bool sequencesEqual(const L (&lhs)[N], const R (&rhs)[N]) {
     for (size_t shift = 0; shift < N; ++shift) {
         bool match = true;
         for (size_t i = 0; i < N; ++i) {
@@ -68,8 +83,117 @@ inline bool approximatelyEqual(double lhs, double rhs) {
     return std::abs(lhs - rhs) < kEps;
 }
 
+template <class V, size_t N>
+bool hasEqualSides(const V (&vertices)[N]) {
+    const double side = vertices[0]->distanceTo(*vertices[1]);
+    if (side < kEps) return false;
+
+    for (size_t i = 1; i < N; ++i) {
+        const double current = vertices[i]->distanceTo(*vertices[(i + 1) % N]);
+        if (!approximatelyEqual(side, current)) return false;
+    }
+    return true;
+}
+
+// Проверки фигур учитывают в инструментировании причину первого отказа.
+template <class V, size_t N>
+bool isRegularPolygon(const V (&vertices)[N]) {
+    if (hasDuplicateVertices(vertices)) {
+        INSTRUMENT_COUNT(RejectDuplicateVertices);
+        return false;
+    }
+    const double area = surface(vertices);
+    if (area < kEps) {
+        INSTRUMENT_COUNT(RejectZeroArea);
+        return false;
+    }
+    if (!hasEqualSides(vertices)) {
+        INSTRUMENT_COUNT(RejectUnequalSides);
+        return false;
+    }
+
+    const auto center = centroid(vertices);
+    const double radius = center.distanceTo(*vertices[0]);
+    if (radius < kEps) {
+        INSTRUMENT_COUNT(RejectZeroArea);
+        return false;
+    }
+
+    for (size_t i = 1; i < N; ++i) {
+        const double currentRadius = center.distanceTo(*vertices[i]);
+        if (!approximatelyEqual(radius, currentRadius)) {
+            INSTRUMENT_COUNT(RejectUnequalRadii);
+            return false;
+        }
+    }
+
+    INSTRUMENT_COUNT(ValidateAccepted);
+    return true;
+}
+
+template <class V>
+bool isRhombus(const V (&vertices)[4]) {
+    if (hasDuplicateVertices(vertices)) {
+        INSTRUMENT_COUNT(RejectDuplicateVertices);
+        return false;
+    }
+    if (surface(vertices) < kEps) {
+        INSTRUMENT_COUNT(RejectZeroArea);
+        return false;
+    }
+    if (!hasEqualSides(vertices)) {
+        INSTRUMENT_COUNT(RejectUnequalSides);
+        return false;
+    }
+
+    const double mid1x =
+        (static_cast<double>(vertices[0]->x) + static_cast<double>(vertices[2]->x)) / 2.0;
+    const double mid1y =
+        (static_cast<double>(vertices[0]->y) + static_cast<double>(vertices[2]->y)) / 2.0;
+    const double mid2x =
+        (static_cast<double>(vertices[1]->x) + static_cast<double>(vertices[3]->x)) / 2.0;
+    const double mid2y =
+        (static_cast<double>(vertices[1]->y) + static_cast<double>(vertices[3]->y)) / 2.0;
+
+    if (!approximatelyEqual(mid1x, mid2x) || !approximatelyEqual(mid1y, mid2y)) {
+        INSTRUMENT_COUNT(RejectDiagonalMidpoints);
+        return false;
+    }
+
+    INSTRUMENT_COUNT(ValidateAccepted);
+    return true;
+}
+
+// Элемент контейнера: сама фигура или указатель на нее.
+template <class E>
+const auto& figureOf(const E& element) {
+    if constexpr (requires { element.center(); })
+        return element;
+    else
+        return *element;
+}
+
+template <class E>
+auto& figureOf(E& element) {
+    if constexpr (requires { element.center(); })
+        return element;
+    else
+        return *element;
+}
+
 }  // namespace figure_detail
 
+// Общий пул вершин (мозаика): вершина, на которую ссылаются несколько фигур,
+// при пакетном преобразовании сдвигается один раз.
+template <IsScalar T>
+class VertexPool {
+public:
+    virtual void transformVertices(std::span<const uint32_t> indices, const Affine& m) = 0;
+
+protected:
+    ~VertexPool() = default;
+};
+
 template <IsScalar T>
 class Figure {
 protected:
@@ -85,6 +209,16 @@ public:
     virtual Point<T> center() const = 0;
     virtual double surface() const = 0;
 
+    virtual size_t vertexCount() const = 0;
+    virtual Point<T> vertex(size_t index) const = 0;
+
+    // Произвольное аффинное преобразование может нарушить validate() (например, сдвиг ромба).
+    virtual void transform(const Affine& m) = 0;
+
+    // Фигура-вид возвращает свой пул и индексы вершин в нем; обычные фигуры — nullptr.
+    virtual VertexPool<T>* vertexPool() const { return nullptr; }
+    virtual std::span<const uint32_t> poolIndices() const { return {}; }
+
     virtual operator double() const = 0;
     virtual bool operator==(const Figure<T>& other) const = 0;
     virtual bool operator!=(const Figure<T>& other) const = 0;
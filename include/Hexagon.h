@@ -11,11 +11,13 @@ class Hexagon : public Figure<T> {
 public:
     Hexagon() {
         for (auto& v : vertices_) v = std::make_unique<Point<T>>();
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
     }
 
     Hexagon(const Hexagon& other) {
         for (size_t i = 0; i < kVertices; ++i)
             vertices_[i] = std::make_unique<Point<T>>(*other.vertices_[i]);
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
     }
 
     Hexagon(Hexagon&& other) noexcept {
@@ -26,6 +28,7 @@ public:
         if (this == &other) return *this;
         for (size_t i = 0; i < kVertices; ++i)
             vertices_[i] = std::make_unique<Point<T>>(*other.vertices_[i]);
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
         return *this;
     }
 
@@ -50,13 +53,28 @@ public:
     }
 
     Point<T> center() const override {
+        INSTRUMENT_COUNT(CenterCalls);
         return figure_detail::centroid(vertices_);
     }
 
     double surface() const override {
+        INSTRUMENT_COUNT(SurfaceCalls);
         return figure_detail::surface(vertices_);
     }
 
+    size_t vertexCount() const override {
+        return kVertices;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        if (index >= kVertices) throw std::out_of_range("Индекс вершины вне диапазона");
+        return *vertices_[index];
+    }
+
+    void transform(const Affine& m) override {
+        figure_detail::transform(vertices_, m);
+    }
+
     operator double() const override {
         return surface();
     }
@@ -72,28 +90,7 @@ public:
     }
 
     bool validate() const override {
-        if (figure_detail::hasDuplicateVertices(vertices_)) return false;
-        const double area = figure_detail::surface(vertices_);
-        if (area < figure_detail::kEps) return false;
-
-        const double side = vertices_[0]->distanceTo(*vertices_[1]);
-        if (side < figure_detail::kEps) return false;
-
-        for (size_t i = 1; i < kVertices; ++i) {
-            const double current = vertices_[i]->distanceTo(*vertices_[(i + 1) % kVertices]);
-            if (!figure_detail::approximatelyEqual(side, current)) return false;
-        }
-
-        const auto centroid = figure_detail::centroid(vertices_);
-        const double radius = centroid.distanceTo(*vertices_[0]);
-        if (radius < figure_detail::kEps) return false;
-
-        for (size_t i = 1; i < kVertices; ++i) {
-            const double currentRadius = centroid.distanceTo(*vertices_[i]);
-            if (!figure_detail::approximatelyEqual(radius, currentRadius)) return false;
-        }
-
-        return true;
+        return figure_detail::isRegularPolygon(vertices_);
     }
 
 private:
@@ -0,0 +1,255 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Счетчики горячих путей включаются определением OOP_LAB4_INSTRUMENT
+// (cmake -DENABLE_INSTRUMENTATION=ON). Без него макросы INSTRUMENT_* пусты
+// и ничего не добавляют в код фигур и Array.
+namespace instrumentation {
+
+#ifdef OOP_LAB4_INSTRUMENT
+constexpr bool kEnabled = true;
+#else
+constexpr bool kEnabled = false;
+#endif
+
+enum class Counter : size_t {
+    FigureAllocations,
+    ArrayReallocations,
+    ArrayElementMoves,
+    ArrayElementCopies,
+    SurfaceCalls,
+    CenterCalls,
+    ValidateAccepted,
+    RejectDuplicateVertices,
+    RejectZeroArea,
+    RejectUnequalSides,
+    RejectUnequalRadii,
+    RejectDiagonalMidpoints,
+    Count
+};
+
+constexpr size_t kCounterCount = static_cast<size_t>(Counter::Count);
+
+inline const char* counterName(Counter counter) {
+    static constexpr const char* kNames[kCounterCount] = {
+        "figure.allocations",
+        "array.reallocations",
+        "array.element_moves",
+        "array.element_copies",
+        "figure.surface_calls",
+        "figure.center_calls",
+        "validate.accepted",
+        "validate.rejected.duplicate_vertices",
+        "validate.rejected.zero_area",
+        "validate.rejected.unequal_sides",
+        "validate.rejected.unequal_radii",
+        "validate.rejected.diagonal_midpoints",
+    };
+    return kNames[static_cast<size_t>(counter)];
+}
+
+struct PhaseStats {
+    uint64_t calls = 0;
+    std::chrono::nanoseconds total{0};
+};
+
+// Сумма по всем потокам на момент вызова snapshot().
+struct Report {
+    std::array<uint64_t, kCounterCount> counters{};
+    std::map<std::string, PhaseStats, std::less<>> phases;
+
+    uint64_t operator[](Counter counter) const { return counters[static_cast<size_t>(counter)]; }
+
+    uint64_t rejected() const {
+        uint64_t sum = 0;
+        for (size_t i = static_cast<size_t>(Counter::RejectDuplicateVertices); i < kCounterCount; ++i)
+            sum += counters[i];
+        return sum;
+    }
+};
+
+}  // namespace instrumentation
+
+namespace instrumentation_detail {
+
+// Блок пишет только его поток; атомарность нужна, чтобы snapshot() из другого
+// потока читал без гонки.
+struct ThreadCounters {
+    std::array<std::atomic<uint64_t>, instrumentation::kCounterCount> counters{};
+    std::mutex phasesMutex;
+    std::map<std::string, instrumentation::PhaseStats, std::less<>> phases;
+
+    void add(instrumentation::Counter counter, uint64_t n) {
+        auto& c = counters[static_cast<size_t>(counter)];
+        c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+
+    void mergeInto(instrumentation::Report& report) {
+        for (size_t i = 0; i < instrumentation::kCounterCount; ++i)
+            report.counters[i] += counters[i].load(std::memory_order_relaxed);
+
+        const std::lock_guard lock(phasesMutex);
+        for (const auto& [name, stats] : phases) {
+            auto& merged = report.phases[name];
+            merged.calls += stats.calls;
+            merged.total += stats.total;
+        }
+    }
+
+    void clear() {
+        for (auto& c : counters) c.store(0, std::memory_order_relaxed);
+        const std::lock_guard lock(phasesMutex);
+        phases.clear();
+    }
+};
+
+// Блоки живых потоков и сумма по уже завершившимся, чтобы число блоков
+// не росло с каждым запуском parallelFor.
+struct Registry {
+    std::mutex mutex;
+    std::vector<ThreadCounters*> blocks;
+    instrumentation::Report retired;
+};
+
+inline Registry& registry() {
+    static Registry instance;
+    return instance;
+}
+
+// Владелец блока потока: при завершении потока счетчики переносятся в retired.
+class LocalBlock {
+public:
+    LocalBlock() {
+        auto& r = registry();
+        const std::lock_guard lock(r.mutex);
+        r.blocks.push_back(&block_);
+    }
+
+    LocalBlock(const LocalBlock&) = delete;
+    LocalBlock& operator=(const LocalBlock&) = delete;
+
+    ~LocalBlock() {
+        auto& r = registry();
+        const std::lock_guard lock(r.mutex);
+        block_.mergeInto(r.retired);
+        std::erase(r.blocks, &block_);
+    }
+
+    ThreadCounters& block() { return block_; }
+
+private:
+    ThreadCounters block_;
+};
+
+inline ThreadCounters& local() {
+    thread_local LocalBlock owner;
+    return owner.block();
+}
+
+}  // namespace instrumentation_detail
+
+namespace instrumentation {
+
+inline Report snapshot() {
+    auto& r = instrumentation_detail::registry();
+    const std::lock_guard lock(r.mutex);
+    Report report = r.retired;
+    for (auto* block : r.blocks) block->mergeInto(report);
+    return report;
+}
+
+// Сбрасывать стоит между фазами работы, когда другие потоки не считают.
+inline void reset() {
+    auto& r = instrumentation_detail::registry();
+    const std::lock_guard lock(r.mutex);
+    r.retired = Report();
+    for (auto* block : r.blocks) block->clear();
+}
+
+inline void dump(std::ostream& os, const Report& report) {
+    os << "=== Инструментирование ===\n";
+    for (size_t i = 0; i < kCounterCount; ++i)
+        os << std::left << std::setw(40) << counterName(static_cast<Counter>(i)) << std::right
+           << report.counters[i] << "\n";
+    for (const auto& [name, stats] : report.phases) {
+        const double ms = std::chrono::duration<double, std::milli>(stats.total).count();
+        os << std::left << std::setw(40) << ("phase." + name) << std::right << stats.calls
+           << " вызовов, " << std::fixed << std::setprecision(3) << ms << " мс\n";
+    }
+}
+
+inline void dump(std::ostream& os = std::cerr) {
+    dump(os, snapshot());
+}
+
+// Время от конструктора до деструктора добавляется к фазе в счетчиках потока.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(std::string_view phase)
+        : phase_(phase), startedAt_(std::chrono::steady_clock::now()) {}
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() {
+        const auto elapsed = std::chrono::steady_clock::now() - startedAt_;
+        auto& block = instrumentation_detail::local();
+        const std::lock_guard lock(block.phasesMutex);
+        auto it = block.phases.find(phase_);
+        if (it == block.phases.end()) it = block.phases.emplace(std::string(phase_), PhaseStats()).first;
+        ++it->second.calls;
+        it->second.total += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed);
+    }
+
+private:
+    std::string_view phase_;
+    std::chrono::steady_clock::time_point startedAt_;
+};
+
+}  // namespace instrumentation
+
+#ifdef OOP_LAB4_INSTRUMENT
+
+namespace instrumentation_detail {
+
+// Конструктор создает реестр раньше себя, поэтому реестр живет до конца дампа.
+struct DumpAtExit {
+    DumpAtExit() { registry(); }
+    ~DumpAtExit() { instrumentation::dump(); }
+};
+
+inline const DumpAtExit dumpAtExit;
+
+}  // namespace instrumentation_detail
+
+#define INSTRUMENT_ADD(counter, n) \
+    ::instrumentation_detail::local().add(::instrumentation::Counter::counter, (n))
+#define INSTRUMENT_COUNT(counter) INSTRUMENT_ADD(counter, 1)
+#define INSTRUMENT_CONCAT_IMPL(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_IMPL(a, b)
+#define INSTRUMENT_SCOPE(phase) \
+    const ::instrumentation::ScopedTimer INSTRUMENT_CONCAT(instrumentScope, __LINE__)(phase)
+
+#else
+
+#define INSTRUMENT_ADD(counter, n) ((void)0)
+#define INSTRUMENT_COUNT(counter) ((void)0)
+#define INSTRUMENT_SCOPE(phase) ((void)0)
+
+#endif
+
+#endif
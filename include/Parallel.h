@@ -0,0 +1,81 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+enum class Execution { Sequential, Parallel };
+
+namespace parallel_detail {
+
+constexpr size_t kForGrain = 4096;
+constexpr size_t kSortGrain = 1 << 15;
+
+inline size_t workerCount(Execution execution, size_t n, size_t grain) {
+    if (execution == Execution::Sequential) return 1;
+    const size_t hardware = std::max<size_t>(1, std::thread::hardware_concurrency());
+    return std::clamp<size_t>(n / grain, 1, hardware);
+}
+
+// Задача 0 выполняется в вызывающем потоке; первое исключение пробрасывается после join.
+template <class Fn>
+void runTasks(size_t count, Fn fn) {
+    if (count == 0) return;
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> threads;
+    threads.reserve(count - 1);
+    auto guarded = [&](size_t task) {
+        try {
+            fn(task);
+        } catch (...) {
+            errors[task] = std::current_exception();
+        }
+    };
+    for (size_t task = 1; task < count; ++task) threads.emplace_back(guarded, task);
+    guarded(0);
+    for (auto& t : threads) t.join();
+    for (const auto& error : errors) {
+        if (error) std::rethrow_exception(error);
+    }
+}
+
+// fn(begin, end) получает непересекающиеся диапазоны индексов [0, n).
+template <class Fn>
+void parallelFor(Execution execution, size_t n, Fn fn, size_t grain = kForGrain) {
+    const size_t workers = workerCount(execution, n, grain);
+    runTasks(workers, [&](size_t w) { fn(n * w / workers, n * (w + 1) / workers); });
+}
+
+// Куски сортируются независимо, затем сливаются попарно за log(workers) раундов.
+template <class RandomIt, class Compare>
+void parallelSort(Execution execution, RandomIt first, RandomIt last, Compare comp) {
+    const size_t n = static_cast<size_t>(last - first);
+    const size_t workers = workerCount(execution, n, kSortGrain);
+    if (workers == 1) {
+        std::sort(first, last, comp);
+        return;
+    }
+
+    std::vector<size_t> bounds(workers + 1);
+    for (size_t w = 0; w <= workers; ++w) bounds[w] = n * w / workers;
+
+    runTasks(workers, [&](size_t w) { std::sort(first + bounds[w], first + bounds[w + 1], comp); });
+
+    for (size_t step = 1; step < workers; step *= 2) {
+        const size_t merges = (workers + 2 * step - 1) / (2 * step);
+        runTasks(merges, [&](size_t m) {
+            const size_t lo = 2 * step * m;
+            const size_t mid = std::min(lo + step, workers);
+            const size_t hi = std::min(lo + 2 * step, workers);
+            if (mid < hi)
+                std::inplace_merge(first + bounds[lo], first + bounds[mid], first + bounds[hi], comp);
+        });
+    }
+}
+
+}  // namespace parallel_detail
+
+#endif
@@ -12,11 +12,13 @@ class Rhombus : public Figure<T> {
 public:
     Rhombus() {
         for (auto& v : vertices_) v = std::make_unique<Point<T>>();
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
     }
 
     Rhombus(const Rhombus& other) {
         for (size_t i = 0; i < kVertices; ++i)
             vertices_[i] = std::make_unique<Point<T>>(*other.vertices_[i]);
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
     }
 
     Rhombus(Rhombus&& other) noexcept {
@@ -27,6 +29,7 @@ public:
         if (this == &other) return *this;
         for (size_t i = 0; i < kVertices; ++i)
             vertices_[i] = std::make_unique<Point<T>>(*other.vertices_[i]);
+        INSTRUMENT_ADD(FigureAllocations, kVertices);
         return *this;
     }
 
@@ -49,13 +52,28 @@ public:
     }
 
     Point<T> center() const override {
+        INSTRUMENT_COUNT(CenterCalls);
         return figure_detail::centroid(vertices_);
     }
 
     double surface() const override {
+        INSTRUMENT_COUNT(SurfaceCalls);
         return figure_detail::surface(vertices_);
     }
 
+    size_t vertexCount() const override {
+        return kVertices;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        if (index >= kVertices) throw std::out_of_range("Индекс вершины вне диапазона");
+        return *vertices_[index];
+    }
+
+    void transform(const Affine& m) override {
+        figure_detail::transform(vertices_, m);
+    }
+
     operator double() const override {
         return surface();
     }
@@ -71,27 +89,7 @@ public:
     }
 
     bool validate() const override {
-        if (figure_detail::hasDuplicateVertices(vertices_)) return false;
-        if (figure_detail::surface(vertices_) < figure_detail::kEps) return false;
-
-        const double side = vertices_[0]->distanceTo(*vertices_[1]);
-        if (side < figure_detail::kEps) return false;
-        for (size_t i = 1; i < kVertices; ++i) {
-            const double current = vertices_[i]->distanceTo(*vertices_[(i + 1) % kVertices]);
-            if (!figure_detail::approximatelyEqual(side, current)) return false;
-        }
-
-        const double mid1x =
-            (static_cast<double>(vertices_[0]->x) + static_cast<double>(vertices_[2]->x)) / 2.0;
-        const double mid1y =
-            (static_cast<double>(vertices_[0]->y) + static_cast<double>(vertices_[2]->y)) / 2.0;
-        const double mid2x =
-            (static_cast<double>(vertices_[1]->x) + static_cast<double>(vertices_[3]->x)) / 2.0;
-        const double mid2y =
-            (static_cast<double>(vertices_[1]->y) + static_cast<double>(vertices_[3]->y)) / 2.0;
-
-        return figure_detail::approximatelyEqual(mid1x, mid2x) &&
-               figure_detail::approximatelyEqual(mid1y, mid2y);
+        return figure_detail::isRhombus(vertices_);
     }
 
 private:
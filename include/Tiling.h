@@ -0,0 +1,322 @@
+#ifndef TILING_H
+#define TILING_H
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <iostream>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+#include "Figure.h"
+
+namespace tiling_detail {
+
+template <IsScalar T>
+struct PointHash {
+    size_t operator()(const Point<T>& p) const {
+        const size_t hx = std::hash<T>()(p.x);
+        const size_t hy = std::hash<T>()(p.y);
+        return hx ^ (hy + 0x9e3779b97f4a7c15ull + (hx << 6) + (hx >> 2));
+    }
+};
+
+}  // namespace tiling_detail
+
+template <IsScalar T, size_t N>
+class TiledPolygon;
+
+// Общий пул вершин без повторов и индексы вершин каждой фигуры (CSR):
+// вершины фигуры f — indices_[offsets_[f] .. offsets_[f + 1]).
+template <IsScalar T>
+class Tiling : public VertexPool<T> {
+public:
+    Tiling() : offsets_{0} {}
+
+    size_t addVertex(const Point<T>& p) {
+        rebuildLookup();
+        const auto [it, inserted] = lookup_.try_emplace(p, static_cast<uint32_t>(vertices_.size()));
+        if (inserted) {
+            if (vertices_.size() >= kMaxIndex) {
+                lookup_.erase(it);
+                throw std::length_error("Слишком много вершин");
+            }
+            vertices_.push_back(p);
+        }
+        return it->second;
+    }
+
+    size_t addFigure(std::span<const size_t> vertexIndices) {
+        if (vertexIndices.size() < 3)
+            throw std::invalid_argument("У фигуры должно быть не менее 3 вершин");
+        for (const size_t index : vertexIndices) {
+            if (index >= vertices_.size()) throw std::out_of_range("Индекс вершины вне диапазона");
+        }
+        if (indices_.size() + vertexIndices.size() >= kMaxIndex)
+            throw std::length_error("Слишком много индексов");
+
+        for (const size_t index : vertexIndices) indices_.push_back(static_cast<uint32_t>(index));
+        offsets_.push_back(static_cast<uint32_t>(indices_.size()));
+        return figureCount() - 1;
+    }
+
+    size_t addFigure(std::initializer_list<size_t> vertexIndices) {
+        return addFigure(std::span<const size_t>(vertexIndices.begin(), vertexIndices.size()));
+    }
+
+    size_t addFigure(const Figure<T>& figure) {
+        std::vector<size_t> vertexIndices(figure.vertexCount());
+        for (size_t v = 0; v < vertexIndices.size(); ++v) vertexIndices[v] = addVertex(figure.vertex(v));
+        return addFigure(vertexIndices);
+    }
+
+    template <size_t N>
+    TiledPolygon<T, N> view(size_t figure) {
+        return TiledPolygon<T, N>(*this, figure);
+    }
+
+    size_t figureCount() const { return offsets_.size() - 1; }
+    size_t vertexCount() const { return vertices_.size(); }
+
+    size_t vertexCount(size_t figure) const { return indices(figure).size(); }
+
+    std::span<const uint32_t> indices(size_t figure) const {
+        if (figure >= figureCount()) throw std::out_of_range("Индекс фигуры вне диапазона");
+        return {indices_.data() + offsets_[figure], indices_.data() + offsets_[figure + 1]};
+    }
+
+    std::span<const Point<T>> vertices() const { return vertices_; }
+
+    const Point<T>& vertex(size_t index) const {
+        if (index >= vertices_.size()) throw std::out_of_range("Индекс вершины вне диапазона");
+        return vertices_[index];
+    }
+
+    // Вершина общая: сдвигаются все фигуры, которые на нее ссылаются.
+    void setVertex(size_t index, const Point<T>& p) {
+        if (index >= vertices_.size()) throw std::out_of_range("Индекс вершины вне диапазона");
+        vertices_[index] = p;
+        lookupValid_ = false;
+    }
+
+    // Освобождает таблицу дедупликации и лишнюю емкость после построения мозаики.
+    void shrinkToFit() {
+        decltype(lookup_)().swap(lookup_);
+        lookupValid_ = false;
+        vertices_.shrink_to_fit();
+        indices_.shrink_to_fit();
+        offsets_.shrink_to_fit();
+    }
+
+    void transform(const Affine& m) {
+        for (auto& v : vertices_) v = m.apply(v);
+        lookupValid_ = false;
+    }
+
+    // Индексы должны быть без повторов; Array::transform собирает их со всех видов.
+    void transformVertices(std::span<const uint32_t> indices, const Affine& m) override {
+        for (const uint32_t index : indices) {
+            if (index >= vertices_.size()) throw std::out_of_range("Индекс вершины вне диапазона");
+        }
+        for (const uint32_t index : indices) vertices_[index] = m.apply(vertices_[index]);
+        lookupValid_ = false;
+    }
+
+    double surface(size_t figure) const {
+        const auto ids = indices(figure);
+        return surfaceOf(ids.data(), ids.data() + ids.size());
+    }
+
+    Point<T> center(size_t figure) const {
+        const auto ids = indices(figure);
+        return centerOf(ids.data(), ids.data() + ids.size());
+    }
+
+    // Площади и центры всей мозаики за один проход по индексному буферу.
+    std::vector<double> surfaces() const {
+        std::vector<double> result(figureCount());
+        for (size_t f = 0; f < result.size(); ++f)
+            result[f] = surfaceOf(indices_.data() + offsets_[f], indices_.data() + offsets_[f + 1]);
+        return result;
+    }
+
+    std::vector<Point<T>> centers() const {
+        std::vector<Point<T>> result(figureCount());
+        for (size_t f = 0; f < result.size(); ++f)
+            result[f] = centerOf(indices_.data() + offsets_[f], indices_.data() + offsets_[f + 1]);
+        return result;
+    }
+
+    double totalSurface() const {
+        double sum = 0.0;
+        for (size_t f = 0; f < figureCount(); ++f)
+            sum += surfaceOf(indices_.data() + offsets_[f], indices_.data() + offsets_[f + 1]);
+        return sum;
+    }
+
+private:
+    static constexpr size_t kMaxIndex = std::numeric_limits<uint32_t>::max();
+
+    std::vector<Point<T>> vertices_;
+    std::vector<uint32_t> indices_;
+    std::vector<uint32_t> offsets_;
+    std::unordered_map<Point<T>, uint32_t, tiling_detail::PointHash<T>> lookup_;
+    bool lookupValid_ = true;
+
+    // После перемещения вершин таблица поиска устарела; пересобирается при следующем addVertex.
+    void rebuildLookup() {
+        if (lookupValid_) return;
+        lookup_.clear();
+        for (size_t i = 0; i < vertices_.size(); ++i)
+            lookup_.try_emplace(vertices_[i], static_cast<uint32_t>(i));
+        lookupValid_ = true;
+    }
+
+    double surfaceOf(const uint32_t* first, const uint32_t* last) const {
+        const size_t n = static_cast<size_t>(last - first);
+        double area = 0.0;
+        for (size_t i = 0; i < n; ++i) {
+            const auto& current = vertices_[first[i]];
+            const auto& next = vertices_[first[(i + 1) % n]];
+            area += static_cast<double>(current.x) * static_cast<double>(next.y) -
+                    static_cast<double>(current.y) * static_cast<double>(next.x);
+        }
+        return std::abs(area) / 2.0;
+    }
+
+    Point<T> centerOf(const uint32_t* first, const uint32_t* last) const {
+        const double n = static_cast<double>(last - first);
+        double sumX = 0.0;
+        double sumY = 0.0;
+        for (const uint32_t* it = first; it != last; ++it) {
+            sumX += static_cast<double>(vertices_[*it].x);
+            sumY += static_cast<double>(vertices_[*it].y);
+        }
+        return Point<T>(static_cast<T>(sumX / n), static_cast<T>(sumY / n));
+    }
+};
+
+// Легкий вид на фигуру мозаики: хранит только ссылку на Tiling и номер фигуры,
+// а правила проверки те же, что у Rhombus (N = 4) и правильных многоугольников.
+template <IsScalar T, size_t N>
+class TiledPolygon : public Figure<T> {
+public:
+    TiledPolygon(Tiling<T>& tiling, size_t figure) : tiling_(&tiling), figure_(figure) {
+        if (tiling.vertexCount(figure) != N)
+            throw std::invalid_argument("Число вершин фигуры не совпадает с видом");
+    }
+
+    void print(std::ostream& os) const override {
+        for (const uint32_t index : tiling_->indices(figure_)) os << tiling_->vertex(index) << " ";
+    }
+
+    void read(std::istream& is) override {
+        if (is.rdbuf() == std::cin.rdbuf())
+            std::cout << "Введите " << N << " вершин фигуры мозаики (x y):\n";
+
+        // Вершины общие с соседями, поэтому в мозаику попадают только проверенные точки.
+        Point<T> points[N];
+        const Point<T>* vertices[N];
+        for (size_t i = 0; i < N; ++i) {
+            is >> points[i];
+            vertices[i] = &points[i];
+        }
+        if (!isValid(vertices)) throw std::invalid_argument("Точки не образуют фигуру мозаики");
+
+        const auto ids = tiling_->indices(figure_);
+        for (size_t i = 0; i < N; ++i) tiling_->setVertex(ids[i], points[i]);
+    }
+
+    Point<T> center() const override {
+        INSTRUMENT_COUNT(CenterCalls);
+        return tiling_->center(figure_);
+    }
+
+    double surface() const override {
+        INSTRUMENT_COUNT(SurfaceCalls);
+        return tiling_->surface(figure_);
+    }
+
+    size_t vertexCount() const override {
+        return N;
+    }
+
+    Point<T> vertex(size_t index) const override {
+        if (index >= N) throw std::out_of_range("Индекс вершины вне диапазона");
+        return tiling_->vertex(tiling_->indices(figure_)[index]);
+    }
+
+    // Сдвигает общие вершины, а значит и соседние фигуры. Несколько видов одной мозаики
+    // преобразуйте через Array::transform или Tiling::transform: иначе общая вершина
+    // сдвигается по разу на каждый вид.
+    void transform(const Affine& m) override {
+        for (const uint32_t index : tiling_->indices(figure_))
+            tiling_->setVertex(index, m.apply(tiling_->vertex(index)));
+    }
+
+    operator double() const override {
+        return surface();
+    }
+
+    bool operator==(const Figure<T>& other) const override {
+        const auto* rhs = dynamic_cast<const TiledPolygon*>(&other);
+        if (!rhs) return false;
+        const Point<T>* lhsVertices[N];
+        const Point<T>* rhsVertices[N];
+        gather(lhsVertices);
+        rhs->gather(rhsVertices);
+        return figure_detail::sequencesEqual(lhsVertices, rhsVertices);
+    }
+
+    bool operator!=(const Figure<T>& other) const override {
+        return !(*this == other);
+    }
+
+    bool validate() const override {
+        const Point<T>* vertices[N];
+        gather(vertices);
+        return isValid(vertices);
+    }
+
+    VertexPool<T>* vertexPool() const override {
+        return tiling_;
+    }
+
+    std::span<const uint32_t> poolIndices() const override {
+        return tiling_->indices(figure_);
+    }
+
+    size_t figureIndex() const { return figure_; }
+
+private:
+    Tiling<T>* tiling_;
+    size_t figure_;
+
+    static bool isValid(const Point<T>* (&vertices)[N]) {
+        if constexpr (N == 4)
+            return figure_detail::isRhombus(vertices);
+        else
+            return figure_detail::isRegularPolygon(vertices);
+    }
+
+    void gather(const Point<T>* (&vertices)[N]) const {
+        const auto ids = tiling_->indices(figure_);
+        for (size_t i = 0; i < N; ++i) vertices[i] = &tiling_->vertex(ids[i]);
+    }
+};
+
+template <IsScalar T>
+using TiledRhombus = TiledPolygon<T, 4>;
+
+template <IsScalar T>
+using TiledPentagon = TiledPolygon<T, 5>;
+
+template <IsScalar T>
+using TiledHexagon = TiledPolygon<T, 6>;
+
+#endif
@@ -1,16 +1,27 @@
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <iomanip>
 #include <memory>
+#include <numeric>
+#include <ranges>
 #include <sstream>
 #include <string>
 #include <stdexcept>
+#include <thread>
+#include <vector>
 
 #include "../include/Array.h"
+#include "../include/ConcurrentArray.h"
+#include "../include/Export.h"
 #include "../include/Hexagon.h"
+#include "../include/Instrumentation.h"
 #include "../include/Pentagon.h"
 #include "../include/Rhombus.h"
+#include "../include/Tiling.h"
 
 namespace {
 
@@ -186,3 +197,746 @@ TEST(ArrayTest, ThrowsOnInvalidOperations) {
     EXPECT_THROW(figures[1], std::out_of_range);
     EXPECT_THROW(figures.remove(5), std::out_of_range);
 }
+
+TEST(ArrayTest, KeepsSmallArraysInline) {
+    Array<Pentagon<double>, 2> pentagons;
+    EXPECT_TRUE(pentagons.isInline());
+    EXPECT_EQ(pentagons.getCapacity(), 2);
+
+    Pentagon<double> p;
+    fillFigure(p, regularPolygonInput<5>(1.5));
+    pentagons.add(p);
+    pentagons.add(p);
+    EXPECT_TRUE(pentagons.isInline());
+
+    pentagons.add(p);
+    EXPECT_FALSE(pentagons.isInline());
+    EXPECT_EQ(pentagons.getSize(), 3);
+    EXPECT_NEAR(pentagons.totalSurface(), 3.0 * double(p), 1e-9);
+    EXPECT_TRUE(pentagons[2] == p);
+}
+
+TEST(ArrayTest, MovesInlineAndHeapArrays) {
+    Pentagon<double> p;
+    fillFigure(p, regularPolygonInput<5>(2.0));
+
+    Array<Pentagon<double>, 4> source;
+    source.add(p);
+    source.add(p);
+
+    Array<Pentagon<double>, 4> moved = std::move(source);
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_EQ(moved.getSize(), 2);
+    EXPECT_EQ(source.getSize(), 0);
+    EXPECT_TRUE(moved[1] == p);
+
+    for (int i = 0; i < 6; ++i) moved.add(p);
+    Array<Pentagon<double>, 4> heap;
+    heap = std::move(moved);
+    EXPECT_FALSE(heap.isInline());
+    EXPECT_EQ(heap.getSize(), 8);
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_EQ(moved.getSize(), 0);
+
+    Array<Pentagon<double>, 4> copy = heap;
+    copy.remove(0);
+    EXPECT_EQ(copy.getSize(), 7);
+    EXPECT_EQ(heap.getSize(), 8);
+    EXPECT_TRUE(copy[6] == p);
+    EXPECT_THROW(copy[7], std::out_of_range);
+}
+
+TEST(ConcurrentArrayTest, AppendsFromManyThreads) {
+    constexpr size_t threads = 4;
+    constexpr size_t perThread = 2000;
+
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+
+    ConcurrentArray<std::shared_ptr<Figure<double>>> figures;
+    std::atomic<bool> done{false};
+    std::thread reader([&] {
+        double seen = 0.0;
+        while (!done.load()) {
+            const size_t size = figures.getSize();
+            for (size_t i = 0; i < size; ++i) {
+                if (const auto* fig = figures.find(i)) seen += double(**fig);
+            }
+        }
+        EXPECT_GE(seen, 0.0);
+    });
+
+    std::vector<std::thread> writers;
+    for (size_t t = 0; t < threads; ++t) {
+        writers.emplace_back([&] {
+            for (size_t i = 0; i < perThread; ++i) figures.add(rhombus);
+        });
+    }
+    for (auto& w : writers) w.join();
+    done = true;
+    reader.join();
+
+    EXPECT_EQ(figures.getSize(), threads * perThread);
+    const auto* first = &figures[0];
+    figures.add(rhombus);
+    EXPECT_EQ(first, &figures[0]);
+
+    Array<std::shared_ptr<Figure<double>>> frozen = figures.freeze();
+    EXPECT_EQ(frozen.getSize(), threads * perThread + 1);
+    EXPECT_EQ(figures.getSize(), 0);
+    EXPECT_NEAR(frozen.totalSurface(), 2.0 * static_cast<double>(frozen.getSize()), 1e-6);
+}
+
+TEST(ConcurrentArrayTest, ThrowsOnUnpublishedIndex) {
+    ConcurrentArray<Pentagon<double>> pentagons;
+    EXPECT_EQ(pentagons.find(0), nullptr);
+    EXPECT_THROW(pentagons[0], std::out_of_range);
+}
+
+TEST(ArrayTest, SnapshotIsolatesLaterWrites) {
+    Pentagon<double> small;
+    fillFigure(small, regularPolygonInput<5>(1.0));
+    Pentagon<double> large;
+    fillFigure(large, regularPolygonInput<5>(3.0));
+
+    Array<Pentagon<double>> pentagons;
+    for (int i = 0; i < 5; ++i) pentagons.add(small);
+
+    const auto snapshot = pentagons.snapshot();
+    EXPECT_TRUE(pentagons.isShared());
+    EXPECT_EQ(&snapshot[0], &static_cast<const Array<Pentagon<double>>&>(pentagons)[0]);
+
+    pentagons.add(large);
+    pentagons.remove(0);
+    pentagons[0] = large;
+    EXPECT_FALSE(pentagons.isShared());
+
+    EXPECT_EQ(snapshot.getSize(), 5);
+    EXPECT_NEAR(snapshot.totalSurface(), 5.0 * double(small), 1e-9);
+    EXPECT_NEAR(pentagons.totalSurface(), 3.0 * double(small) + 2.0 * double(large), 1e-9);
+}
+
+TEST(ArrayTest, CopiesDoNotAliasAfterGrowth) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    for (int i = 0; i < 4; ++i) figures.add(std::make_shared<Rhombus<double>>());
+
+    auto copy = figures;
+    copy.add(std::make_shared<Rhombus<double>>());
+    figures.remove(0);
+
+    EXPECT_EQ(copy.getSize(), 5);
+    EXPECT_EQ(figures.getSize(), 3);
+}
+
+TEST(ArrayTest, SnapshotsAreReadableWhileWriterContinues) {
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+
+    Array<std::shared_ptr<Figure<double>>> figures;
+    std::vector<std::thread> readers;
+    for (int round = 0; round < 8; ++round) {
+        for (int i = 0; i < 100; ++i) figures.add(rhombus);
+        figures.remove(0);
+
+        readers.emplace_back([snapshot = figures.snapshot()] {
+            double total = 0.0;
+            for (size_t i = 0; i < snapshot.getSize(); ++i) total += double(*snapshot[i]);
+            EXPECT_NEAR(total, 2.0 * static_cast<double>(snapshot.getSize()), 1e-6);
+        });
+    }
+    for (auto& r : readers) r.join();
+    EXPECT_EQ(figures.getSize(), 8 * 99);
+}
+
+TEST(ArrayTest, RemovesMatchingFiguresInOnePass) {
+    Array<Pentagon<double>> pentagons;
+    for (int i = 1; i <= 10; ++i) {
+        Pentagon<double> p;
+        fillFigure(p, regularPolygonInput<5>(static_cast<double>(i)));
+        pentagons.add(p);
+    }
+    const double threshold = double(pentagons[4]);
+    const auto snapshot = pentagons.snapshot();
+
+    EXPECT_EQ(pentagons.removeIf([&](const Pentagon<double>& p) { return double(p) > threshold; }),
+              5);
+    EXPECT_EQ(pentagons.getSize(), 5);
+    EXPECT_NEAR(double(pentagons[4]), threshold, 1e-9);
+    EXPECT_EQ(snapshot.getSize(), 10);
+
+    EXPECT_EQ(pentagons.removeIf([](const Pentagon<double>&) { return false; }), 0);
+    EXPECT_EQ(pentagons.getSize(), 5);
+}
+
+TEST(ArrayTest, ErasesRangesAndSwapRemoves) {
+    Array<Pentagon<double>> pentagons;
+    std::vector<double> areas;
+    for (int i = 1; i <= 6; ++i) {
+        Pentagon<double> p;
+        fillFigure(p, regularPolygonInput<5>(static_cast<double>(i)));
+        areas.push_back(double(p));
+        pentagons.add(p);
+    }
+
+    pentagons.erase(1, 3);
+    EXPECT_EQ(pentagons.getSize(), 4);
+    EXPECT_NEAR(double(pentagons[1]), areas[3], 1e-9);
+
+    pentagons.swapRemove(0);
+    EXPECT_EQ(pentagons.getSize(), 3);
+    EXPECT_NEAR(double(pentagons[0]), areas[5], 1e-9);
+    EXPECT_NEAR(double(pentagons[2]), areas[4], 1e-9);
+
+    EXPECT_THROW(pentagons.erase(2, 1), std::out_of_range);
+    EXPECT_THROW(pentagons.erase(0, 4), std::out_of_range);
+    EXPECT_THROW(pentagons.swapRemove(3), std::out_of_range);
+}
+
+TEST(ArrayTest, RemoveIfKeepsArrayUsableWhenPredicateThrows) {
+    Array<Pentagon<double>, 0, FigureAggregates> pentagons;
+    for (int i = 1; i <= 6; ++i) {
+        Pentagon<double> p;
+        fillFigure(p, regularPolygonInput<5>(static_cast<double>(i)));
+        pentagons.add(p);
+    }
+    const double first = double(pentagons[0]);
+    const double third = double(pentagons[2]);
+    const double total = pentagons.totalSurface();
+
+    int calls = 0;
+    auto dropFirstThenThrow = [&](const Pentagon<double>&) {
+        if (++calls == 3) throw std::runtime_error("pred");
+        return calls == 1;
+    };
+    {
+        const auto snapshot = pentagons.snapshot();
+        EXPECT_THROW(pentagons.removeIf(dropFirstThenThrow), std::runtime_error);
+        EXPECT_EQ(pentagons.getSize(), 6);
+        EXPECT_NEAR(pentagons.totalSurface(), total, 1e-9);
+    }
+
+    calls = 0;
+    EXPECT_THROW(pentagons.removeIf(dropFirstThenThrow), std::runtime_error);
+    EXPECT_EQ(pentagons.getSize(), 5);
+    EXPECT_NEAR(double(pentagons[1]), third, 1e-9);
+    EXPECT_NEAR(pentagons.totalSurface(), total - first, 1e-9);
+    const double actual = pentagons.totalSurface();
+    pentagons.refreshAggregates();
+    EXPECT_NEAR(pentagons.totalSurface(), actual, 1e-9);
+}
+
+TEST(ArrayTest, MaintainsAggregatesIncrementally) {
+    Array<std::shared_ptr<Figure<double>>, 0, FigureAggregates> figures;
+
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+    auto pentagon = std::make_shared<Pentagon<double>>();
+    fillFigure(*pentagon, regularPolygonInput<5>(2.0));
+    auto hexagon = std::make_shared<Hexagon<double>>();
+    fillFigure(*hexagon, regularPolygonInput<6>(1.0));
+
+    figures.add(rhombus);
+    figures.add(pentagon);
+    figures.add(rhombus);
+    EXPECT_NEAR(figures.totalSurface(), 4.0 + double(*pentagon), 1e-9);
+    EXPECT_EQ(figures.aggregates().countOf<Rhombus<double>>(), 2);
+    EXPECT_NEAR(figures.aggregates().centerSum().x, 2.0, 1e-9);
+
+    figures.replace(0, hexagon);
+    EXPECT_EQ(figures.aggregates().countOf<Rhombus<double>>(), 1);
+    EXPECT_EQ(figures.aggregates().countOf<Hexagon<double>>(), 1);
+    EXPECT_NEAR(figures.totalSurface(), 2.0 + double(*pentagon) + double(*hexagon), 1e-9);
+
+    figures.removeIf([](const auto& fig) { return double(*fig) < 2.5; });
+    figures.swapRemove(0);
+    EXPECT_EQ(figures.getSize(), 1);
+    EXPECT_EQ(figures.aggregates().count(), 1);
+    EXPECT_NEAR(figures.totalSurface(), double(*pentagon), 1e-9);
+
+    const auto snapshot = figures.snapshot();
+    figures.remove(0);
+    EXPECT_NEAR(figures.totalSurface(), 0.0, 1e-9);
+    EXPECT_NEAR(snapshot.totalSurface(), double(*pentagon), 1e-9);
+}
+
+TEST(ArrayTest, UpdateKeepsAggregatesWhenCallbackThrows) {
+    Array<Rhombus<double>, 0, FigureAggregates> rhombi;
+    Rhombus<double> rhombus;
+    fillFigure(rhombus, "0 0 1 1 2 0 1 -1");
+    rhombi.add(rhombus);
+    rhombi.add(rhombus);
+
+    EXPECT_THROW(rhombi.update(0,
+                               [](Rhombus<double>& r) {
+                                   r.transform(Affine::scaling(2.0, 2.0));
+                                   throw std::runtime_error("fn");
+                               }),
+                 std::runtime_error);
+    EXPECT_EQ(rhombi.aggregates().count(), 2);
+    EXPECT_NEAR(rhombi.totalSurface(), 8.0 + 2.0, 1e-9);
+    const double total = rhombi.totalSurface();
+    rhombi.refreshAggregates();
+    EXPECT_NEAR(rhombi.totalSurface(), total, 1e-9);
+}
+
+TEST(ArrayTest, CompensatesAreaSummation) {
+    Array<Rhombus<double>, 0, FigureAggregates> rhombi;
+    Rhombus<double> big;
+    fillFigure(big, "0 0 1e8 1e8 2e8 0 1e8 -1e8");
+    Rhombus<double> tiny;
+    fillFigure(tiny, "0 0 0.001 0.001 0.002 0 0.001 -0.001");
+
+    rhombi.add(big);
+    for (int i = 0; i < 1000; ++i) rhombi.add(tiny);
+    rhombi.remove(0);
+    EXPECT_NEAR(rhombi.totalSurface(), 1000.0 * double(tiny), 1e-12);
+}
+
+static_assert(std::ranges::contiguous_range<Array<Pentagon<double>>>);
+static_assert(std::ranges::contiguous_range<const Array<std::shared_ptr<Figure<double>>, 4>>);
+static_assert(std::ranges::contiguous_range<Array<Rhombus<double>, 0, FigureAggregates>::Snapshot>);
+
+TEST(ArrayTest, WorksWithStandardAlgorithmsAndRanges) {
+    Array<Pentagon<double>, 2> pentagons;
+    for (int i = 3; i >= 1; --i) {
+        Pentagon<double> p;
+        fillFigure(p, regularPolygonInput<5>(static_cast<double>(i)));
+        pentagons.add(p);
+    }
+
+    std::ranges::sort(pentagons, {}, [](const Pentagon<double>& p) { return double(p); });
+    EXPECT_LT(double(pentagons.unchecked(0)), double(pentagons.unchecked(2)));
+
+    auto areas = pentagons.span() |
+                 std::views::transform([](const Pentagon<double>& p) { return double(p); });
+    EXPECT_NEAR(std::accumulate(areas.begin(), areas.end(), 0.0), pentagons.totalSurface(), 1e-9);
+
+    const auto snapshot = pentagons.snapshot();
+    for (auto& p : pentagons) p = Pentagon<double>(snapshot[2]);
+    EXPECT_EQ(snapshot.span().size(), 3);
+    EXPECT_TRUE(snapshot[0] != pentagons[0]);
+    EXPECT_EQ(pentagons.data(), &pentagons[0]);
+}
+
+TEST(ArrayTest, OrdersAndSelectsBySurface) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    const double radii[] = {3.0, 1.0, 5.0, 2.0, 4.0};
+    for (double r : radii) {
+        auto hexagon = std::make_shared<Hexagon<double>>();
+        fillFigure(*hexagon, regularPolygonInput<6>(r));
+        figures.add(hexagon);
+    }
+
+    EXPECT_EQ(figures.orderBySurface(), (std::vector<size_t>{1, 3, 0, 4, 2}));
+    EXPECT_EQ(figures.topBySurface(2), (std::vector<size_t>{2, 4}));
+    EXPECT_EQ(figures.topBySurface(10).size(), 5);
+
+    const auto snapshot = figures.snapshot();
+    figures.sortBySurface();
+    for (size_t i = 1; i < figures.getSize(); ++i)
+        EXPECT_LT(double(*figures[i - 1]), double(*figures[i]));
+    EXPECT_EQ(snapshot[0], figures[2]);
+}
+
+TEST(ArrayTest, ParallelOrderingMatchesSequential) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    for (size_t i = 0; i < 40000; ++i) {
+        auto rhombus = std::make_shared<Rhombus<double>>();
+        const double x = static_cast<double>((i * 7919) % 1000);
+        const double y = static_cast<double>((i * 104729) % 997);
+        const double h = 1.0 + static_cast<double>(i % 13);
+        std::ostringstream oss;
+        oss << x << ' ' << y << ' ' << x + 1 << ' ' << y + h << ' ' << x + 2 << ' ' << y << ' '
+            << x + 1 << ' ' << y - h;
+        fillFigure(*rhombus, oss.str());
+        figures.add(rhombus);
+    }
+
+    EXPECT_EQ(figures.orderBySurface(Execution::Parallel), figures.orderBySurface());
+    EXPECT_EQ(figures.orderByMorton(Execution::Parallel), figures.orderByMorton());
+    EXPECT_EQ(figures.topBySurface(100, Execution::Parallel), figures.topBySurface(100));
+
+    figures.sortByMorton(Execution::Parallel);
+    EXPECT_EQ(figures.orderByMorton(), [] {
+        std::vector<size_t> identity(40000);
+        std::iota(identity.begin(), identity.end(), 0);
+        return identity;
+    }());
+}
+
+TEST(ArrayTest, AppliesAffineTransformToAllFigures) {
+    Array<std::shared_ptr<Figure<double>>, 0, FigureAggregates> figures;
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+    auto pentagon = std::make_shared<Pentagon<double>>();
+    fillFigure(*pentagon, regularPolygonInput<5>(2.0));
+    figures.add(rhombus);
+    figures.add(pentagon);
+    const double before = figures.totalSurface();
+
+    const Affine m = Affine::rotation(PI / 6.0).then(Affine::scaling(2.0, 2.0)).then(
+        Affine::translation(10.0, -5.0));
+    figures.transform(m, Execution::Parallel);
+
+    EXPECT_NEAR(figures.totalSurface(), 4.0 * before, 1e-9);
+    EXPECT_NEAR(double(*rhombus) + double(*pentagon), figures.totalSurface(), 1e-9);
+
+    const auto c = rhombus->center();
+    const auto expected = m.apply(Point<double>(1.0, 0.0));
+    EXPECT_NEAR(c.x, expected.x, 1e-9);
+    EXPECT_NEAR(c.y, expected.y, 1e-9);
+
+    const auto sum = figures.aggregates().centerSum();
+    EXPECT_NEAR(sum.x, c.x + pentagon->center().x, 1e-9);
+    EXPECT_NEAR(sum.y, c.y + pentagon->center().y, 1e-9);
+}
+
+TEST(ArrayTest, TransformsFigureStoredTwiceOnce) {
+    Array<std::shared_ptr<Figure<double>>, 0, FigureAggregates> figures;
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+    figures.add(rhombus);
+    figures.add(rhombus);
+
+    figures.transform(Affine::scaling(2.0, 2.0), Execution::Parallel);
+    EXPECT_NEAR(double(*rhombus), 8.0, 1e-9);
+    EXPECT_NEAR(figures.totalSurface(), 16.0, 1e-9);
+    figures.refreshAggregates();
+    EXPECT_NEAR(figures.totalSurface(), 16.0, 1e-9);
+
+    {
+        const auto snapshot = figures.snapshot();
+        EXPECT_THROW(figures.transform(Affine::translation(1.0, 0.0)), std::logic_error);
+
+        // Запись отделяет буфер писателя, но фигуры по-прежнему общие со снимком.
+        auto pentagon = std::make_shared<Pentagon<double>>();
+        fillFigure(*pentagon, regularPolygonInput<5>(1.0));
+        figures.add(pentagon);
+        figures.remove(2);
+        EXPECT_FALSE(figures.isShared());
+        EXPECT_THROW(figures.transform(Affine::translation(5.0, 0.0)), std::logic_error);
+        EXPECT_NEAR(snapshot[0]->center().x, 2.0, 1e-9);
+    }
+
+    figures.transform(Affine::translation(5.0, 0.0));
+    EXPECT_NEAR(rhombus->center().x, 7.0, 1e-9);
+}
+
+TEST(ArrayTest, SnapshotIsolatedFromEarlierMutableReferences) {
+    Array<Hexagon<double>> hexagons;
+    Hexagon<double> h;
+    fillFigure(h, regularPolygonInput<6>(1.0));
+    hexagons.add(h);
+    hexagons.add(h);
+
+    Hexagon<double>& first = hexagons[0];
+    const std::span<Hexagon<double>> all = hexagons.span();
+    const auto snapshot = hexagons.snapshot();
+    EXPECT_FALSE(hexagons.isShared());
+
+    first.transform(Affine::translation(3.0, 0.0));
+    all[1].transform(Affine::translation(0.0, 4.0));
+    EXPECT_NEAR(hexagons[0].center().x, 3.0, 1e-9);
+    EXPECT_NEAR(hexagons[1].center().y, 4.0, 1e-9);
+    EXPECT_NEAR(snapshot[0].center().x, 0.0, 1e-9);
+    EXPECT_NEAR(snapshot[1].center().y, 0.0, 1e-9);
+
+    // После перевыделения старые ссылки недействительны, и снимок снова делит буфер.
+    hexagons.reserve(64);
+    const auto shared = hexagons.snapshot();
+    EXPECT_TRUE(hexagons.isShared());
+    EXPECT_NEAR(shared[0].center().x, 3.0, 1e-9);
+}
+
+TEST(ArrayTest, TransformsValueFiguresWithoutTouchingSnapshots) {
+    Array<Hexagon<double>, 2> hexagons;
+    Hexagon<double> h;
+    fillFigure(h, regularPolygonInput<6>(1.0));
+    hexagons.add(h);
+    hexagons.add(h);
+    hexagons.add(h);
+
+    const auto snapshot = hexagons.snapshot();
+    hexagons.transform(Affine::translation(3.0, 4.0));
+    EXPECT_NEAR(hexagons[0].center().x, 3.0, 1e-9);
+    EXPECT_NEAR(snapshot[0].center().x, 0.0, 1e-9);
+    EXPECT_NEAR(hexagons.totalSurface(), snapshot.totalSurface(), 1e-9);
+}
+
+TEST(ExportTest, TextMatchesPrintSurfacesAndCenters) {
+    Array<std::shared_ptr<Figure<double>>> figures;
+    auto rhombus = std::make_shared<Rhombus<double>>();
+    fillFigure(*rhombus, "0 0 1 1 2 0 1 -1");
+    auto hexagon = std::make_shared<Hexagon<double>>();
+    fillFigure(*hexagon, regularPolygonInput<6>(2.345, 0.3));
+    figures.add(rhombus);
+    figures.add(hexagon);
+
+    std::ostringstream expected;
+    auto* old = std::cout.rdbuf(expected.rdbuf());
+    const auto oldFlags = std::cout.flags();
+    const auto oldPrecision = std::cout.precision();
+    figures.printSurfaces();
+    figures.printCenters();
+    std::cout.rdbuf(old);
+    std::cout.flags(oldFlags);
+    std::cout.precision(oldPrecision);
+
+    StringSink sink;
+    {
+        Exporter<StringSink> exporter(sink);
+        exporter.writeSurfaces(figures);
+        exporter.writeCenters(figures);
+    }
+    EXPECT_EQ(sink.str(), expected.str());
+}
+
+TEST(ExportTest, WritesCsvAndJson) {
+    Array<Rhombus<double>> rhombi;
+    Rhombus<double> rhombus;
+    fillFigure(rhombus, "0 0 1 1 2 0 1 -1");
+    rhombi.add(rhombus);
+
+    StringSink csv;
+    Exporter<StringSink>(csv, ExportFormat::Csv).writeSurfaces(rhombi);
+    EXPECT_EQ(csv.str(),
+              "index,area,center_x,center_y,vertices\n"
+              "0,2.00,1.00,0.00,0.00 0.00 1.00 1.00 2.00 0.00 1.00 -1.00\n");
+
+    StringSink json;
+    Exporter<StringSink>(json, ExportFormat::Json, 1).writeSurfaces(rhombi);
+    EXPECT_EQ(json.str(),
+              "[\n{\"index\":0,\"area\":2.0,\"center\":[1.0,0.0],"
+              "\"vertices\":[[0.0,0.0],[1.0,1.0],[2.0,0.0],[1.0,-1.0]]}\n]\n");
+
+    rhombi.transform(Affine::scaling(1e200, 1e200));
+    StringSink overflow;
+    Exporter<StringSink>(overflow, ExportFormat::Json, 0).writeSurfaces(rhombi);
+    EXPECT_NE(overflow.str().find("\"area\":null,"), std::string::npos);
+
+    StringSink sink;
+    EXPECT_THROW(Exporter<StringSink>(sink, ExportFormat::Csv, 450), std::invalid_argument);
+    EXPECT_THROW(Exporter<StringSink>(sink, ExportFormat::Csv, -1), std::invalid_argument);
+}
+
+TEST(ExportTest, FlushesSmallBuffersToFileDescriptor) {
+    Array<Rhombus<double>> rhombi;
+    Rhombus<double> rhombus;
+    fillFigure(rhombus, "0 0 1e100 1e100 2e100 0 1e100 -1e100");
+    for (int i = 0; i < 50; ++i) rhombi.add(rhombus);
+
+    std::FILE* file = std::tmpfile();
+    ASSERT_NE(file, nullptr);
+    FileDescriptorSink fdSink(fileno(file));
+    {
+        Exporter<FileDescriptorSink> exporter(fdSink, ExportFormat::Csv, 2, 64);
+        exporter.writeCenters(rhombi);
+    }
+
+    StringSink expected;
+    Exporter<StringSink>(expected, ExportFormat::Csv).writeCenters(rhombi);
+
+    std::string written(expected.str().size() + 1, '\0');
+    std::rewind(file);
+    written.resize(std::fread(written.data(), 1, written.size(), file));
+    std::fclose(file);
+    EXPECT_EQ(written, expected.str());
+}
+
+namespace {
+
+// Ромбы с центрами в узлах (x, y), x + y нечетно; соседние ромбы делят вершины.
+Tiling<double> rhombusTiling(int width, int height) {
+    Tiling<double> tiling;
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            if ((x + y) % 2 == 0) continue;
+            const double cx = x;
+            const double cy = y;
+            tiling.addFigure({tiling.addVertex({cx - 1, cy}), tiling.addVertex({cx, cy + 1}),
+                              tiling.addVertex({cx + 1, cy}), tiling.addVertex({cx, cy - 1})});
+        }
+    }
+    return tiling;
+}
+
+}  // namespace
+
+TEST(TilingTest, SharesVerticesBetweenNeighbours) {
+    Tiling<double> tiling = rhombusTiling(20, 20);
+    EXPECT_EQ(tiling.figureCount(), 200);
+    EXPECT_LT(tiling.vertexCount(), 2 * tiling.figureCount());
+    EXPECT_NEAR(tiling.totalSurface(), 2.0 * 200, 1e-9);
+
+    const auto areas = tiling.surfaces();
+    const auto centers = tiling.centers();
+    ASSERT_EQ(areas.size(), 200);
+    EXPECT_NEAR(areas[7], 2.0, 1e-9);
+    EXPECT_NEAR(centers[0].x, 0.0, 1e-9);
+    EXPECT_NEAR(centers[0].y, 1.0, 1e-9);
+
+    const size_t vertices = tiling.vertexCount();
+    const size_t shared = tiling.addVertex({1.0, 1.0});
+    EXPECT_EQ(tiling.vertexCount(), vertices);
+    size_t touching = 0;
+    for (size_t f = 0; f < tiling.figureCount(); ++f) {
+        for (const uint32_t index : tiling.indices(f)) touching += index == shared;
+    }
+    EXPECT_EQ(touching, 4);
+
+    tiling.setVertex(shared, {1.0, 1.5});
+    size_t moved = 0;
+    for (size_t f = 0; f < tiling.figureCount(); ++f)
+        moved += std::abs(centers[f].y - tiling.center(f).y) > 1e-9;
+    EXPECT_EQ(moved, 4);
+
+    tiling.shrinkToFit();
+    EXPECT_EQ(tiling.addVertex({1.0, 1.5}), shared);
+
+    const double before = tiling.surface(0);
+    TiledRhombus<double> neighbour = tiling.view<4>(1);
+    EXPECT_THROW(fillFigure(neighbour, "2.5 0 3 1 4 0 3 -1"), std::invalid_argument);
+    EXPECT_EQ(tiling.surface(0), before);
+}
+
+TEST(TilingTest, ViewsBehaveLikeFigures) {
+    Tiling<double> tiling;
+    Rhombus<double> rhombus;
+    fillFigure(rhombus, "0 0 1 1 2 0 1 -1");
+    Hexagon<double> hexagon;
+    fillFigure(hexagon, regularPolygonInput<6>(1.0, 0.25));
+    tiling.addFigure(rhombus);
+    tiling.addFigure(rhombus);
+    tiling.addFigure(hexagon);
+    EXPECT_EQ(tiling.vertexCount(), 10);
+
+    Array<std::shared_ptr<Figure<double>>> figures;
+    figures.add(std::make_shared<TiledRhombus<double>>(tiling.view<4>(0)));
+    figures.add(std::make_shared<TiledHexagon<double>>(tiling.view<6>(2)));
+    EXPECT_NEAR(figures.totalSurface(), double(rhombus) + double(hexagon), 1e-9);
+    EXPECT_TRUE(*figures[0] == tiling.view<4>(1));
+    EXPECT_THROW(tiling.view<5>(0), std::invalid_argument);
+
+    TiledRhombus<double> view = tiling.view<4>(1);
+    EXPECT_THROW(fillFigure(view, "0 0 2 0 3 1 1 1"), std::invalid_argument);
+    EXPECT_NEAR(double(*figures[0]), 2.0, 1e-9);
+    fillFigure(view, "0 0 1 2 2 0 1 -2");
+    EXPECT_NEAR(double(*figures[0]), 4.0, 1e-9);
+
+    tiling.transform(Affine::scaling(2.0, 2.0));
+    EXPECT_NEAR(tiling.totalSurface(), 4.0 * (4.0 + 4.0 + double(hexagon)), 1e-9);
+}
+
+TEST(InstrumentationTest, CountsHotPathsAcrossThreads) {
+    using instrumentation::Counter;
+    instrumentation::reset();
+
+    std::thread worker([] {
+        Array<Rhombus<double>> rhombi;
+        Rhombus<double> rhombus;
+        fillFigure(rhombus, "0 0 1 1 2 0 1 -1");
+        for (int i = 0; i < 5; ++i) rhombi.add(rhombus);
+        rhombi.remove(0);
+        EXPECT_NEAR(rhombi.totalSurface(), 8.0, 1e-9);
+    });
+    worker.join();
+
+    Pentagon<double> pentagon;
+    EXPECT_THROW(fillFigure(pentagon, "0 0 0 0 1 0 1 1 0 1"), std::invalid_argument);
+    EXPECT_THROW(fillFigure(pentagon, "0 0 2 0 3 0 4 0 5 0"), std::invalid_argument);
+    Rhombus<double> parallelogram;
+    EXPECT_THROW(fillFigure(parallelogram, "0 0 2 0 3 1 1 1"), std::invalid_argument);
+
+    const auto report = instrumentation::snapshot();
+    if constexpr (instrumentation::kEnabled) {
+        // Ромб и 5 его копий в рабочем потоке, пятиугольник и ромб в этом.
+        EXPECT_EQ(report[Counter::FigureAllocations], 4 * 6 + 5 * 1 + 4 * 1);
+        EXPECT_EQ(report[Counter::ArrayReallocations], 2);
+        EXPECT_EQ(report[Counter::ArrayElementMoves], 4 + 4);
+        EXPECT_EQ(report[Counter::SurfaceCalls], 4);
+        EXPECT_EQ(report[Counter::ValidateAccepted], 1);
+        EXPECT_EQ(report[Counter::RejectDuplicateVertices], 1);
+        EXPECT_EQ(report[Counter::RejectZeroArea], 1);
+        EXPECT_EQ(report[Counter::RejectUnequalSides], 1);
+        EXPECT_EQ(report.rejected(), 3);
+    } else {
+        for (const uint64_t value : report.counters) EXPECT_EQ(value, 0);
+    }
+}
+
+TEST(InstrumentationTest, MergesScopedTimersOnDemand) {
+    instrumentation::reset();
+    auto work = [] {
+        for (int i = 0; i < 3; ++i) {
+            const instrumentation::ScopedTimer timer("ingest");
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+    std::thread worker(work);
+    work();
+    worker.join();
+
+    const auto report = instrumentation::snapshot();
+    ASSERT_EQ(report.phases.count("ingest"), 1);
+    EXPECT_EQ(report.phases.at("ingest").calls, 6);
+    EXPECT_GE(report.phases.at("ingest").total, std::chrono::milliseconds(6));
+
+    std::ostringstream oss;
+    instrumentation::dump(oss, report);
+    EXPECT_NE(oss.str().find("phase.ingest"), std::string::npos);
+    EXPECT_NE(oss.str().find("validate.accepted"), std::string::npos);
+
+    instrumentation::reset();
+    EXPECT_TRUE(instrumentation::snapshot().phases.empty());
+}
+
+TEST(InstrumentationTest, RetiresCountersOfFinishedThreads) {
+    instrumentation::reset();
+    instrumentation::ScopedTimer{"warmup"};
+    auto& registry = instrumentation_detail::registry();
+    const size_t blocks = [&] {
+        const std::lock_guard lock(registry.mutex);
+        return registry.blocks.size();
+    }();
+
+    for (int i = 0; i < 50; ++i) {
+        std::thread([] { const instrumentation::ScopedTimer timer("short"); }).join();
+    }
+
+    {
+        const std::lock_guard lock(registry.mutex);
+        EXPECT_EQ(registry.blocks.size(), blocks);
+    }
+    EXPECT_EQ(instrumentation::snapshot().phases.at("short").calls, 50);
+    instrumentation::reset();
+    EXPECT_TRUE(instrumentation::snapshot().phases.empty());
+}
+
+TEST(TilingTest, ArrayTransformMovesSharedVerticesOnce) {
+    Tiling<double> tiling;
+    Rhombus<double> left;
+    fillFigure(left, "0 0 1 1 2 0 1 -1");
+    Rhombus<double> right;
+    fillFigure(right, "2 0 3 1 4 0 3 -1");
+    tiling.addFigure(left);
+    tiling.addFigure(right);
+    ASSERT_EQ(tiling.vertexCount(), 7);
+
+    Array<std::shared_ptr<Figure<double>>, 0, FigureAggregates> figures;
+    figures.add(std::make_shared<TiledRhombus<double>>(tiling.view<4>(0)));
+    figures.add(std::make_shared<TiledRhombus<double>>(tiling.view<4>(1)));
+    figures.transform(Affine::translation(10.0, 0.0), Execution::Parallel);
+
+    EXPECT_NEAR(tiling.vertex(2).x, 12.0, 1e-9);
+    EXPECT_NEAR(tiling.surface(0), 2.0, 1e-9);
+    EXPECT_NEAR(tiling.surface(1), 2.0, 1e-9);
+    EXPECT_NEAR(figures.totalSurface(), 4.0, 1e-9);
+    EXPECT_NEAR(figures.aggregates().centerSum().x, 11.0 + 13.0, 1e-9);
+
+    Array<TiledRhombus<double>> views;
+    views.add(tiling.view<4>(0));
+    views.add(tiling.view<4>(1));
+    views.transform(Affine::scaling(2.0, 1.0));
+    EXPECT_NEAR(tiling.vertex(2).x, 24.0, 1e-9);
+    EXPECT_NEAR(tiling.totalSurface(), 8.0, 1e-9);
+}